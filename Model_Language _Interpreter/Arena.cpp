@@ -0,0 +1,156 @@
+#include <memory_resource>
+#include <stack>
+#include <deque>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+
+//________________________________________________________ARENA________________________________________________________
+// Bump allocator owning all the memory of a single run. Blocks are rounded up to a power of two and cut from large
+// chunks; freed blocks are kept in per-size lists and reused within the run (so the executor's temporaries do not make
+// the arena grow without bound). Nothing is returned to the system until the arena is destroyed: reset() makes all the
+// chunks available to the next run at once.
+class Arena : public pmr::memory_resource
+{
+	static const size_t CHUNK_SIZE = 1 << 16;							// size of the first chunk (each next one is twice as large)
+	static const size_t MIN_BLOCK = 16;									// smallest block (also the alignment of all blocks)
+	static const int SIZE_CLASSES = 48;
+
+	struct Chunk
+	{
+		Chunk *next;
+		size_t size;
+		alignas(MIN_BLOCK) char data[MIN_BLOCK];
+	};
+
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	Chunk *chunks;														// list of all chunks
+	Chunk *active;														// chunk being cut at the moment
+	size_t top;															// offset of the free space in the active chunk
+	FreeBlock *freeLists[SIZE_CLASSES];									// freed blocks by size class
+
+	size_t used;														// bytes currently allocated
+	size_t peak;														// maximum of used bytes since the last reset
+
+	// Size class of a block (its size is MIN_BLOCK << class)
+	static int sizeClass(size_t bytes)
+	{
+		int c = 0;
+		while ((MIN_BLOCK << c) < bytes)
+			c++;
+		return c;
+	}
+
+	// Cut a new block from the chunks
+	void* cut(size_t size)
+	{
+		while (!active || top + size > active->size)					// the active chunk is full: move on to the next one
+		{
+			if (active && active->next && active->next->size >= size)	//   reuse a chunk kept from a previous run
+				active = active->next;
+			else														//   or add a new chunk after the active one
+			{
+				size_t chunkSize = active ? 2 * active->size : CHUNK_SIZE;
+				while (chunkSize < size)
+					chunkSize *= 2;
+				Chunk *chunk = (Chunk*) malloc(offsetof(Chunk, data) + chunkSize);
+				chunk->size = chunkSize;
+				if (active)
+				{
+					chunk->next = active->next;
+					active->next = chunk;
+				}
+				else
+				{
+					chunk->next = chunks;
+					chunks = chunk;
+				}
+				active = chunk;
+			}
+			top = 0;
+		}
+		void *block = active->data + top;
+		top += size;
+		return block;
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		int c = sizeClass(max(bytes, alignment));
+		size_t size = MIN_BLOCK << c;
+		void *block;
+		if (freeLists[c])												// reuse a freed block of the same size
+		{
+			block = freeLists[c];
+			freeLists[c] = freeLists[c]->next;
+		}
+		else
+			block = cut(size);
+
+		used += size;
+		if (used > peak)
+			peak = used;
+		return block;
+	}
+
+	void do_deallocate(void *block, size_t bytes, size_t alignment) override
+	{
+		int c = sizeClass(max(bytes, alignment));
+		FreeBlock *freed = (FreeBlock*) block;
+		freed->next = freeLists[c];
+		freeLists[c] = freed;
+		used -= MIN_BLOCK << c;
+	}
+
+	bool do_is_equal(const pmr::memory_resource &other) const noexcept override
+	{
+		return this == &other;
+	}
+
+public:
+	Arena(): chunks(nullptr), active(nullptr), top(0), used(0), peak(0)
+	{
+		memset(freeLists, 0, sizeof(freeLists));
+	}
+
+	Arena(const Arena&) = delete;
+	Arena& operator = (const Arena&) = delete;
+
+	~Arena()
+	{
+		while (chunks)
+		{
+			Chunk *next = chunks->next;
+			free(chunks);
+			chunks = next;
+		}
+	}
+
+	// Forget everything allocated so far. The chunks are kept for the next run
+	void reset()
+	{
+		active = chunks;
+		top = 0;
+		memset(freeLists, 0, sizeof(freeLists));
+		used = 0;
+		peak = 0;
+	}
+
+	// Maximum number of bytes in use since the last reset
+	size_t getPeak()
+	{
+		return peak;
+	}
+};
+
+// Stack keeping its items in an arena
+template <class T>
+using arenaStack = stack<T, pmr::deque<T>>;
@@ -0,0 +1,168 @@
+#include <vector>
+#include <cstdint>
+#include "Verifier.cpp"
+
+using namespace std;
+
+
+//____________________________________________DEFINITE ASSIGNMENT ANALYSIS_____________________________________________
+// Forward dataflow over the basic blocks of a verified RPN. An identifier is definitely assigned at an instruction if
+// it is assigned (or read into) on every path leading there: the sets of such identifiers are intersected where the
+// paths meet. Loads of definitely assigned identifiers are replaced with RPN_LOAD, which skips the runtime check; the
+// other loads keep the checked LEX_ID (so reading an identifier without a value is still an execution error).
+class AssignmentAnalysis
+{
+public:
+	typedef vector<uint64_t> identSet;									// one bit per identifier
+
+private:
+	pmr::vector<Lexeme> &RPNs;
+	const Verifier &verifier;
+	int size;
+	int words;															// number of words in an identifier set
+
+	vector<int> blockStart;												// first instruction of each basic block
+	vector<int> blockOf;												// basic block of each instruction
+
+	static bool contains(const identSet &set, int ident)
+	{
+		return set[ident >> 6] >> (ident & 63) & 1;
+	}
+
+	static void insert(identSet &set, int ident)
+	{
+		set[ident >> 6] |= (uint64_t) 1 << (ident & 63);
+	}
+
+	// Split the RPN into basic blocks: they start at the program's beginning, at jump targets and after jumps
+	void findBlocks()
+	{
+		vector<bool> isLeader(size + 1, false);
+		isLeader[0] = true;
+		for (int i = 0; i < size; i++)
+		{
+			lexemeType type = RPNs[i].getType();
+			if ((type == RPN_GO || type == RPN_FGO) && verifier.getJump(i) >= 0)
+			{
+				isLeader[verifier.getJump(i)] = true;
+				isLeader[i + 1] = true;
+			}
+		}
+
+		blockOf.assign(size, 0);
+		for (int i = 0; i < size; i++)
+		{
+			if (isLeader[i])
+				blockStart.push_back(i);
+			blockOf[i] = blockStart.size() - 1;
+		}
+		blockStart.push_back(size);										// end of the last block
+	}
+
+public:
+	AssignmentAnalysis(pmr::vector<Lexeme> &rpn, const Verifier &v):
+		RPNs(rpn), verifier(v), size(rpn.size()), words((identTable.size() + 63) / 64)
+	{}
+
+	// Replace the loads of definitely assigned identifiers with unchecked ones
+	void markLoads()
+	{
+		identSet none;
+		follow(none, false);
+	}
+
+	// Replace the loads in the RPN of a part of a program (e.g. one of its statements), entered with the given
+	// identifiers assigned, with the paths through it verified to leave it at its end. The set is replaced with the
+	// identifiers assigned at the end
+	void markLoads(identSet &assigned)
+	{
+		follow(assigned, true);
+	}
+
+private:
+	void follow(identSet &assigned, bool part)
+	{
+		assigned.resize(words, 0);										// identifiers added to the table since are not assigned
+		if (size == 0)
+			return;
+		findBlocks();
+		int blocks = blockStart.size() - 1;
+
+		vector<identSet> in(blocks);									// identifiers assigned when a block is entered
+		vector<bool> reached(blocks, false);
+		vector<int> work = {0};
+		in[0] = assigned;
+		reached[0] = true;
+		bool ended = false;												// indicator that a path has come to the end
+
+		while (!work.empty())
+		{
+			int block = work.back();
+			work.pop_back();
+
+			identSet out = in[block];
+			for (int i = blockStart[block]; i < blockStart[block + 1]; i++)
+				if (verifier.getAssigned(i) >= 0)
+					insert(out, verifier.getAssigned(i));
+
+			int last = blockStart[block + 1] - 1;
+			int successors[2];
+			int count = 0;
+			if (RPNs[last].getType() == RPN_GO)
+				successors[count++] = verifier.getJump(last);
+			else
+			{
+				if (RPNs[last].getType() == RPN_FGO)
+					successors[count++] = verifier.getJump(last);
+				successors[count++] = last + 1;
+			}
+
+			for (int k = 0; k < count; k++)
+			{
+				if (successors[k] < 0 || successors[k] >= size)			// the program ends there
+				{
+					if (part && successors[k] == size)					//   the paths leaving the part meet at its end
+					{
+						for (int w = 0; w < words && ended; w++)
+							assigned[w] &= out[w];
+						if (!ended)
+							assigned = out;
+						ended = true;
+					}
+					continue;
+				}
+				int next = blockOf[successors[k]];
+				if (!reached[next])
+				{
+					reached[next] = true;
+					in[next] = out;
+					work.push_back(next);
+					continue;
+				}
+				bool changed = false;
+				for (int w = 0; w < words; w++)
+				{
+					uint64_t meet = in[next][w] & out[w];
+					changed |= meet != in[next][w];
+					in[next][w] = meet;
+				}
+				if (changed)
+					work.push_back(next);
+			}
+		}
+
+		for (int block = 0; block < blocks; block++)
+		{
+			if (!reached[block])
+				continue;
+			identSet current = in[block];
+			for (int i = blockStart[block]; i < blockStart[block + 1]; i++)
+			{
+				if (RPNs[i].getType() == LEX_ID && contains(current, RPNs[i].getValue()))
+					RPNs[i] = Lexeme(RPN_LOAD, RPNs[i].getValue());
+				if (verifier.getAssigned(i) >= 0)
+					insert(current, verifier.getAssigned(i));
+			}
+		}
+	}
+};
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include "Interpreter.cpp"
+#include "ThreadPool.cpp"
+
+using namespace std;
+
+
+//_______________________________________________________BATCH RUN_____________________________________________________
+// Result of one program of the batch
+struct batchResult
+{
+	string fileName;
+	string output;														// everything the run has written (output, warnings, errors)
+	int status;															// executionStatus
+	bool compiled;														// indicator that the times are known
+	runTimes times;
+};
+
+// Milliseconds of a duration
+double milliseconds(chrono::steady_clock::duration d)
+{
+	return chrono::duration<double, milli>(d).count();
+}
+
+// Add the program files of a path: a file itself, or every file of a directory and its subdirectories.
+// Files named *.in are inputs of the programs, not programs
+void addPrograms(const string &path, vector<string> &programs)
+{
+	namespace fs = filesystem;
+	if (!fs::is_directory(path))
+	{
+		programs.push_back(path);
+		return;
+	}
+	vector<string> found;
+	for (auto &entry : fs::recursive_directory_iterator(path))
+		if (entry.is_regular_file() && entry.path().extension() != ".in")
+			found.push_back(entry.path().string());
+	sort(found.begin(), found.end());
+	programs.insert(programs.end(), found.begin(), found.end());
+}
+
+// Interpret one program. Its read() takes the values from the file <program>.in (if there is one)
+void runProgram(batchResult &result, const executionOptions &options)
+{
+	static thread_local Arena arena;									// memory is reused by the runs of a worker
+
+	ostringstream output;
+	ifstream inputFile(result.fileName + ".in");
+	istringstream noInput;
+	programStreams streams;
+	streams.in = inputFile.is_open() ? (istream*) &inputFile : (istream*) &noInput;
+	streams.out = &output;
+	streams.err = &output;
+
+	result.compiled = false;
+	try
+	{
+		Interpreter interpreter(ProgramSource::fromFile(result.fileName), STREAM_INPUT, &arena, streams);
+		interpreter.setOptions(options);
+		interpreter.setTiming(true);
+		result.status = interpreter.interpret();
+		result.times = interpreter.getTimes();
+		result.compiled = true;
+	}
+	catch (InterpreterError &error)
+	{
+		output << error.what() << endl;
+		result.status = EXEC_ERROR;
+	}
+	result.output = output.str();
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: BatchInterpreter [--threads N] [--quiet] [--fuel N] [--max-string-bytes N] [--time-limit MS] paths...
+int main(int argc, char *argv[])
+{
+	vector<string> programs;
+	executionOptions options = executionOptions();
+	int threads = 0;
+	bool quiet = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--threads" && i + 1 < argc)							// number of workers (the machine's threads by default)
+			threads = atoi(argv[++i]);
+		else if (arg == "--quiet")										// do not print the programs' output
+			quiet = true;
+		else if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+			addPrograms(arg, programs);
+	}
+	if (programs.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--threads N] [--quiet] [--fuel N] [--max-string-bytes N] [--time-limit MS] "
+			 << "program files or directories...\n";
+		return 1;
+	}
+
+	vector<batchResult> results(programs.size());
+	ThreadPool pool(threads);
+	for (size_t i = 0; i < programs.size(); i++)
+	{
+		results[i].fileName = programs[i];
+		pool.submit([&results, &options, i] { runProgram(results[i], options); });
+	}
+
+	auto start = chrono::steady_clock::now();
+	pool.run();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	int failed = 0;
+	runTimes total = runTimes();
+	cout << fixed << setprecision(3);
+	for (auto &result : results)
+	{
+		if (!quiet)
+			cout << "==================== " << result.fileName << " ====================\n" << result.output;
+		cout << "[" << (result.status == EXEC_OK ? "OK" : "FAILED") << " " << result.status << "] " << result.fileName;
+		if (result.compiled)
+		{
+			cout << "  lex " << milliseconds(result.times.lex) << " ms, parse " << milliseconds(result.times.parse)
+				 << " ms, exec " << milliseconds(result.times.exec) << " ms";
+			total.lex += result.times.lex;
+			total.parse += result.times.parse;
+			total.exec += result.times.exec;
+		}
+		cout << "\n";
+		if (!quiet)
+			cout << "\n";
+		failed += result.status != EXEC_OK;
+	}
+
+	cout << "\n" << results.size() << " programs (" << failed << " failed) on " << pool.size() << " threads in "
+		 << seconds << " s: " << results.size() / seconds << " programs/s\n"
+		 << "Total lex " << milliseconds(total.lex) << " ms, parse " << milliseconds(total.parse)
+		 << " ms, exec " << milliseconds(total.exec) << " ms\n";
+	return failed ? 1 : 0;
+}
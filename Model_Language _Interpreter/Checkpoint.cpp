@@ -0,0 +1,121 @@
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "CompiledProgram.cpp"
+
+using namespace std;
+
+
+//______________________________________________________CHECKPOINT_____________________________________________________
+// Binary image of the state of a run, saved at a safe point so that a later run of the same program may go on from it.
+// The items are written as they are in memory (a checkpoint is read on the machine it has been written on): the
+// header, the items of the executer, and a checksum of everything before it
+const uint32_t CHECKPOINT_MAGIC = 0x4b43504d;							// "MPCK"
+const uint32_t CHECKPOINT_VERSION = 2;								// 2: the calls of functions being made
+
+class CheckpointWriter
+{
+	string image;
+
+public:
+	template <class T>
+	void put(T item)
+	{
+		static_assert(is_trivially_copyable_v<T>, "only plain items are written as they are");
+		image.append((const char*) &item, sizeof(T));
+	}
+
+	void putString(string_view text)
+	{
+		put<uint64_t>(text.size());
+		image.append(text);
+	}
+
+	// Write the image with its checksum to the file. The file is replaced at once (a run stopped while writing
+	// leaves the previous checkpoint as it was). Returns false if the file cannot be written
+	bool save(const string &fileName)
+	{
+		put<uint64_t>(fnvHash(image.data(), image.size()));
+		string temporary = fileName + ".tmp";
+		{
+			ofstream file(temporary, ios::binary | ios::trunc);
+			if (!file.write(image.data(), image.size()) || !file.flush())
+				return false;
+		}
+		return rename(temporary.c_str(), fileName.c_str()) == 0;
+	}
+};
+
+class CheckpointReader
+{
+	string image;
+	size_t pos;
+	bool failed;														// indicator that an item has been missing
+
+public:
+	CheckpointReader(): pos(0), failed(false) {}
+
+	// Read the file. Returns false if there is no such file (a damaged one fails the check of completeness)
+	bool load(const string &fileName)
+	{
+		ifstream file(fileName, ios::binary);
+		if (!file)
+			return false;
+		image.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+		uint64_t checksum;
+		if (image.size() < sizeof(checksum))
+		{
+			failed = true;
+			return true;
+		}
+		size_t size = image.size() - sizeof(checksum);
+		memcpy(&checksum, image.data() + size, sizeof(checksum));
+		image.resize(size);
+		failed = checksum != fnvHash(image.data(), image.size());
+		return true;
+	}
+
+	template <class T>
+	T get()
+	{
+		T item = T();
+		if (image.size() - pos < sizeof(T))
+			failed = true;
+		else
+		{
+			memcpy((void*) &item, image.data() + pos, sizeof(T));
+			pos += sizeof(T);
+		}
+		return item;
+	}
+
+	string_view getString()
+	{
+		uint64_t size = get<uint64_t>();
+		if (image.size() - pos < size)
+		{
+			failed = true;
+			return string_view();
+		}
+		string_view text(image.data() + pos, size);
+		pos += size;
+		return text;
+	}
+
+	// Bytes not read yet
+	size_t remaining() const
+	{
+		return image.size() - pos;
+	}
+
+	// Check that the file has not been damaged, every item has been there and nothing is left over
+	bool complete() const
+	{
+		return !failed && pos == image.size();
+	}
+};
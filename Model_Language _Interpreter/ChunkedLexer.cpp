@@ -0,0 +1,276 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include "TokenPipeline.cpp"
+
+using namespace std;
+
+
+//____________________________________________________CHUNKED LEXER____________________________________________________
+// Scanner of a large program split into parts (chunks) at line ends, which are scanned on several threads at once.
+// A chunk may begin inside a /* */ comment or (after a line continuation) inside a string constant, which only the
+// text before it can tell (the scanner also keeps the text of a comment until the next lexeme, which shows in the
+// value of a quote). So a quick pre-pass first follows every chunk from each of these states at once, and then the
+// chunks are chained from the beginning of the program: a chunk starts in the state its predecessor ends in.
+// A chunk starting inside a string is joined to its predecessor (a string constant is one lexeme).
+// Every chunk numbers its own symbols in the order they first appear in it; the chunks' numbers are then mapped in
+// order to those of the whole program, so the lexemes and the tables are exactly those of a single scanner.
+class ChunkedLexer : public LexemeSource
+{
+	static constexpr size_t MIN_CHUNK = 1 << 16;						// smallest chunk worth a thread
+
+	enum textState														// where a line begins
+	{
+		IN_CODE,
+		AFTER_COMMENT,													// in the code, with no lexeme since a /* */ comment
+		IN_COMMENT,
+		IN_STRING,
+		TEXT_STATES
+	};
+
+	struct chunk
+	{
+		size_t begin;
+		size_t end;
+		textState exits[TEXT_STATES];									// state at the end of the chunk for each state at its beginning
+		textState start;
+
+		vector<Lexeme> lexemes;
+		vector<string> idents;											// identifiers in the order of their first appearance
+		vector<string> strConsts;										// string constants in the order of their first appearance
+		vector<int> identNumbers;										// numbers of the chunk's identifiers in the program
+		vector<int> strConstNumbers;
+		size_t offset;													// position of the chunk's first lexeme in the program
+		bool failed;													// indicator that a lexical error has stopped the chunk
+		string error;
+	};
+
+	Scanner &scanner;
+	int threads;
+	bool scanned;
+	vector<Lexeme> lexemes;												// lexemes of the whole program
+	size_t nextLexeme;
+	bool failed;														// indicator that a lexical error follows the last lexeme
+	string error;
+
+	// Follow the text from the given state, as far as comments and string constants are concerned
+	static textState follow(string_view text, textState state);
+
+	// Scan a chunk, numbering its symbols by itself
+	void scanChunk(string_view text, chunk &part);
+
+	// Run the function for every chunk, one thread for each
+	template <class Function>
+	static void forEachChunk(vector<chunk> &chunks, Function function)
+	{
+		vector<thread> workers;
+		for (size_t i = 1; i < chunks.size(); i++)
+			workers.emplace_back(function, ref(chunks[i]));
+		function(chunks[0]);											// the calling thread takes the first chunk
+		for (auto &worker : workers)
+			worker.join();
+	}
+
+	void scan();
+
+public:
+	ChunkedLexer(Scanner &s, int count): scanner(s), threads(max(count, 1)), scanned(false), nextLexeme(0), failed(false) {}
+
+	Lexeme next() override
+	{
+		if (!scanned)													// the program is scanned when the parser asks for its first lexeme
+			scan();
+		if (nextLexeme < lexemes.size())
+			return lexemes[nextLexeme++];
+		if (failed)
+		{
+			failed = false;
+			throw InterpreterError(error);
+		}
+		return Lexeme(LEX_FIN);
+	}
+};
+
+
+ChunkedLexer::textState ChunkedLexer::follow(string_view text, textState state)
+{
+	size_t i = 0;
+	size_t size = text.size();
+	while (i < size)
+	{
+		char c = text[i];
+		switch (state)
+		{
+			case IN_CODE: case AFTER_COMMENT:
+				if (c == '\"')
+					state = IN_STRING;
+				else if (c == '/' && i + 1 < size && text[i + 1] == '*')
+				{
+					state = IN_COMMENT;
+					i++;
+				}
+				else if (c == '/' && i + 1 < size && text[i + 1] == '/')	// a one-line comment ends with its line
+				{
+					state = IN_CODE;
+					i = text.find('\n', i);
+					if (i == string_view::npos)
+						return state;
+				}
+				else if (c != ' ' && c != '\n' && c != '\r' && c != '\t')	// a lexeme
+					state = IN_CODE;
+				i++;
+				break;
+
+			case IN_COMMENT:
+				if (c == '*' && i + 1 < size && text[i + 1] == '/')
+				{
+					state = AFTER_COMMENT;
+					i += 2;												// the scanner skips the character after a comment as well
+				}
+				i++;
+				break;
+
+			case IN_STRING:
+				if (c == '\\')											// an escape sequence (or a line continuation)
+					i++;
+				else if (c == '\"' || c == '\n')						// the end of the string (or a lexical error)
+					state = IN_CODE;
+				i++;
+				break;
+
+			default:
+				return state;
+		}
+	}
+	return state;
+}
+
+void ChunkedLexer::scanChunk(string_view text, chunk &part)
+{
+	Scanner chunkScanner(
+		text.substr(part.begin, part.end - part.begin),
+		part.start == IN_COMMENT,
+		part.start == AFTER_COMMENT,
+		scanner.getMemory()
+	);
+	chunkScanner.deferTables();
+	part.failed = false;
+	try
+	{
+		string symbol;
+		while (true)
+		{
+			Lexeme lex = chunkScanner.getLexeme();
+			if (lex.getType() == LEX_FIN)
+				break;
+			part.lexemes.push_back(lex);
+			if (chunkScanner.takeNewSymbol(symbol))
+				(lex.getType() == LEX_ID ? part.idents : part.strConsts).push_back(symbol);
+		}
+	}
+	catch (InterpreterError &err)
+	{
+		part.failed = true;
+		part.error = err.what();
+	}
+}
+
+void ChunkedLexer::scan()
+{
+	scanned = true;
+	string_view text = scanner.getText();
+
+	vector<chunk> chunks;												// split the text at line ends
+	size_t chunkSize = max(text.size() / threads, MIN_CHUNK);
+	size_t begin = 0;
+	while (begin < text.size())
+	{
+		size_t end = text.find('\n', min(begin + chunkSize, text.size()) - 1);
+		end = end == string_view::npos ? text.size() : end + 1;
+		chunks.push_back(chunk());
+		chunks.back().begin = begin;
+		chunks.back().end = end;
+		begin = end;
+	}
+	if (chunks.empty())
+	{
+		chunks.push_back(chunk());
+		chunks.back().begin = chunks.back().end = 0;
+	}
+
+	forEachChunk(chunks, [text](chunk &part)							// pre-pass: follow every chunk from every state
+	{
+		string_view partText = text.substr(part.begin, part.end - part.begin);
+		for (int state = 0; state < TEXT_STATES; state++)
+			part.exits[state] = follow(partText, textState(state));
+	});
+
+	vector<chunk> joined;												// chain the chunks, joining those that begin in a string
+	textState state = IN_CODE;
+	for (auto &part : chunks)
+	{
+		textState start = state;
+		state = part.exits[start];
+		if (start == IN_STRING && !joined.empty())
+		{
+			joined.back().end = part.end;
+			continue;
+		}
+		part.start = start;
+		joined.push_back(move(part));
+	}
+
+	forEachChunk(joined, [this, text](chunk &part)
+	{
+		scanChunk(text, part);
+	});
+
+	unordered_map<string, int> identNumbers;							// map the chunks' symbols to those of the program
+	unordered_map<string, int> strConstNumbers;							// (a symbol new to them is new to the tables as well)
+	size_t count = 0;
+	size_t used = 0;													// chunks up to the first lexical error
+	while (used < joined.size())
+	{
+		chunk &part = joined[used++];
+		for (auto &name : part.idents)
+		{
+			auto [it, added] = identNumbers.emplace(name, identNumbers.size());
+			if (added)
+				identTable.push_back(Identifier(name, scanner.getMemory()));
+			part.identNumbers.push_back(it->second);
+		}
+		for (auto &str : part.strConsts)
+		{
+			auto [it, added] = strConstNumbers.emplace(str, strConstNumbers.size());
+			if (added)
+				strConstTable.push_back(str);
+			part.strConstNumbers.push_back(it->second);
+		}
+		part.offset = count;
+		count += part.lexemes.size();
+		if (part.failed)
+		{
+			failed = true;
+			error = part.error;
+			break;
+		}
+	}
+	joined.resize(used);
+
+	lexemes.resize(count);
+	forEachChunk(joined, [this](chunk &part)
+	{
+		for (size_t i = 0; i < part.lexemes.size(); i++)
+		{
+			Lexeme lex = part.lexemes[i];
+			if (lex.getType() == LEX_ID)
+				lex = Lexeme(LEX_ID, part.identNumbers[lex.getValue()]);
+			else if (lex.getType() == LEX_STR_CONST)
+				lex = Lexeme(LEX_STR_CONST, part.strConstNumbers[lex.getValue()]);
+			lexemes[part.offset + i] = lex;
+		}
+		vector<Lexeme>().swap(part.lexemes);
+	});
+}
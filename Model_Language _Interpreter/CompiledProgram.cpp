@@ -0,0 +1,313 @@
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include "AssignmentAnalysis.cpp"
+
+using namespace std;
+
+
+//________________________________________________________HASH_________________________________________________________
+// 64-bit FNV-1a hash of the bytes, going on from the given hash
+uint64_t fnvHash(const void *data, size_t size, uint64_t hash=0xcbf29ce484222325ULL)
+{
+	const unsigned char *bytes = (const unsigned char*) data;
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	return hash;
+}
+
+
+//__________________________________________________COMPILED PROGRAM___________________________________________________
+// Packed form of the RPN the executer runs. Every instruction is a 32-bit word: an 8-bit opcode (the lexeme type) and
+// a 24-bit operand. An operand that does not fit is replaced with the escape value and put in the next word as it is.
+// Labels are translated from RPN indices to positions in the packed code. The types and names of the identifiers and
+// the string constants are copied out of the tables, and the result of the verification is kept with the code, so a
+// compiled program is complete in itself: it is never changed by a run, and any number of runs on any threads may
+// share it. The program of a text being edited has parts of its code replaced between its runs (see replace()).
+// The native functions the program calls are kept with it as well (they are never changed once registered), and so
+// are the types of the results and the local variables of the functions it defines.
+class CompiledProgram
+{
+	static const int OPERAND_SHIFT = 8;
+	static const uint32_t OPCODE_MASK = (1 << OPERAND_SHIFT) - 1;
+	static const uint32_t WIDE_OPERAND = (1 << 24) - 1;					// escape: the operand is in the next word
+
+	static_assert(RPN_LOCAL_ADDRESS <= OPCODE_MASK, "lexeme types must fit in the opcode");
+
+	pmr::vector<uint32_t> code;
+	pmr::vector<bool> starts;											// indicator that a word starts an instruction
+	pmr::vector<lexemeType> identTypes;
+	pmr::vector<pmr::string> identNames;
+	pmr::vector<string> strConsts;
+	verification check;
+	shared_ptr<const NativeFunctions> natives;							// functions of the host program (none - nullptr)
+	pmr::vector<programFunction> functions;								// functions of the program
+	mutable uint64_t fingerprint;										// hash of everything a run depends on
+	mutable bool fingerprinted;											// indicator that the fingerprint is up to date
+	bool wideLabels;													// indicator that every label takes two words
+
+	void emit(lexemeType type, long long value, bool wide)
+	{
+		starts.push_back(true);
+		if (!wide)
+		{
+			code.push_back((uint32_t) value << OPERAND_SHIFT | type);
+			return;
+		}
+		code.push_back(WIDE_OPERAND << OPERAND_SHIFT | type);
+		code.push_back((uint32_t) value);
+		starts.push_back(false);
+	}
+
+	static bool fits(long long value)
+	{
+		return value >= 0 && value < WIDE_OPERAND;
+	}
+
+	// Pack the RPN at the end of the code. Its labels are counted from its first instruction, which goes to the given
+	// position
+	void pack(const pmr::vector<Lexeme> &RPNs, int base)
+	{
+		int size = RPNs.size();
+		vector<int> position(size + 1);									// position of each RPN instruction in the code
+		int words = base;
+		for (int i = 0; i < size; i++)
+		{
+			position[i] = words;
+			words += instructionWords(RPNs[i]);
+		}
+		position[size] = words;
+
+		code.reserve(words);
+		starts.reserve(words);
+		for (int i = 0; i < size; i++)
+		{
+			lexemeType type = RPNs[i].getType();
+			int value = RPNs[i].getValue();
+			if (type == RPN_LABEL)
+			{
+				if (value < 0 || value > size)							// not a jump target: left for the executer to reject
+					emit(type, value, true);
+				else
+					emit(type, position[value], wideLabels);
+			}
+			else
+				emit(type, value, !fits(value));
+		}
+	}
+
+	// Put the items in place of those at [from, to), moving the ones after them only once
+	template <class T>
+	static void splice(pmr::vector<T> &items, int from, int to, const pmr::vector<T> &put)
+	{
+		int count = put.size();
+		if (count > to - from)
+			items.insert(items.begin() + to, put.begin() + (to - from), put.end());
+		else
+			items.erase(items.begin() + from + count, items.begin() + to);
+		copy(put.begin(), put.begin() + min(count, to - from), items.begin() + from);
+	}
+
+	// Copy the types and names of the identifiers and the string constants added to the tables since
+	void copyTables()
+	{
+		for (size_t i = 0; i < identTable.size(); i++)
+		{
+			if (i < identTypes.size())
+				identTypes[i] = identTable[i].getType();				// a variable may have been declared since
+			else
+			{
+				identTypes.push_back(identTable[i].getType());
+				identNames.emplace_back(string_view(identTable[i].getName()));
+			}
+		}
+		strConsts.insert(strConsts.end(), strConstTable.begin() + strConsts.size(), strConstTable.end());
+	}
+
+	uint64_t computeFingerprint() const
+	{
+		uint64_t hash = fnvHash(code.data(), code.size() * sizeof(uint32_t));
+		hash = fnvHash(identTypes.data(), identTypes.size() * sizeof(lexemeType), hash);
+		for (auto &name : identNames)									// the names are in the messages of the runs' errors
+			hash = fnvHash(name.data(), name.size() + 1, hash);
+		for (auto &str : strConsts)
+			hash = fnvHash(str.data(), str.size() + 1, hash);			// with the terminator, so constants do not run together
+		for (int i = 0; natives && i < natives->size(); i++)			// the calls are numbered by the functions
+			hash = fnvHash(natives->get(i).name.data(), natives->get(i).name.size() + 1, hash);
+		for (auto &function : functions)
+		{
+			hash = fnvHash(&function.result, sizeof(lexemeType), hash);
+			hash = fnvHash(&function.params, sizeof(int), hash);
+			hash = fnvHash(function.locals.data(), function.locals.size() * sizeof(lexemeType), hash);
+			hash = fnvHash(function.names.data(), function.names.size() * sizeof(int), hash);
+		}
+		return hash;
+	}
+
+public:
+	CompiledProgram(const pmr::vector<Lexeme> &RPNs, const verification &verified, pmr::memory_resource *memory,
+					shared_ptr<const NativeFunctions> nativeFunctions=nullptr,
+					const vector<programFunction> &programFunctions=vector<programFunction>()):
+		code(memory), starts(memory), identTypes(memory), identNames(memory), strConsts(memory), check(verified),
+		natives(move(nativeFunctions)), functions(programFunctions.begin(), programFunctions.end(), memory)
+	{
+		copyTables();
+		wideLabels = !fits(2LL * RPNs.size());							// a packed program is at most twice as long as the RPN
+		pack(RPNs, 0);
+		fingerprint = computeFingerprint();
+		fingerprinted = true;
+	}
+
+	// Copy of the program kept in the given memory (e.g. to outlive the arena of the interpreter that has compiled it)
+	CompiledProgram(const CompiledProgram &other, pmr::memory_resource *memory):
+		code(other.code, memory),
+		starts(other.starts, memory),
+		identTypes(other.identTypes, memory),
+		identNames(other.identNames, memory),
+		strConsts(other.strConsts, memory),
+		check(other.check),
+		natives(other.natives),
+		functions(other.functions, memory),
+		fingerprint(other.getFingerprint()),
+		fingerprinted(true),
+		wideLabels(other.wideLabels)
+	{}
+
+	// Number of words the RPN instruction is packed into
+	int instructionWords(const Lexeme &lex) const
+	{
+		return (lex.getType() == RPN_LABEL ? wideLabels : !fits(lex.getValue())) ? 2 : 1;
+	}
+
+	// Replace the code at [from, to) with the packed RPN of a part of the program (its labels counted from its first
+	// instruction), moving the labels of the code after it. The tables are copied again, since the part may have added
+	// identifiers and string constants to them. Returns false, leaving the program as it was, if the labels no longer
+	// fit in the code (the whole program has to be packed anew)
+	bool replace(int from, int to, const pmr::vector<Lexeme> &part, const verification &verified)
+	{
+		int words = 0;
+		for (auto &lex : part)
+			words += instructionWords(lex);
+		int delta = words - (to - from);
+		if (!wideLabels && !fits(2LL * (code.size() + delta)))
+			return false;
+
+		pmr::vector<uint32_t> packed(code.get_allocator());			// the part, packed while the code is put aside
+		pmr::vector<bool> packedStarts(starts.get_allocator());
+		packed.swap(code);
+		packedStarts.swap(starts);
+		pack(part, from);
+		packed.swap(code);
+		packedStarts.swap(starts);
+
+		for (int i = to; delta && i < (int) code.size(); i++)			// the labels of the code after the part are moved
+		{
+			bool label = (code[i] & OPCODE_MASK) == RPN_LABEL;
+			if (code[i] >> OPERAND_SHIFT == WIDE_OPERAND)
+				code[++i] += label ? delta : 0;
+			else if (label)
+				code[i] += (uint32_t) delta << OPERAND_SHIFT;
+		}
+		splice(code, from, to, packed);
+		splice(starts, from, to, packedStarts);
+
+		copyTables();
+		check = verified;
+		fingerprinted = false;											// hashed again only if it is asked for
+		return true;
+	}
+
+	// Fetch the instruction at the given position, moving the position to its last word
+	Lexeme fetch(int &index) const
+	{
+		uint32_t word = code[index];
+		uint32_t operand = word >> OPERAND_SHIFT;
+		if (operand == WIDE_OPERAND)
+			operand = code[++index];
+		return Lexeme(lexemeType(word & OPCODE_MASK), (int) operand);
+	}
+
+	// Opcode of the instruction at the given position
+	lexemeType opcode(int index) const
+	{
+		return lexemeType(code[index] & OPCODE_MASK);
+	}
+
+	// Check that a jump may go to the given position (an instruction or the end of the program)
+	bool isJumpTarget(int index) const
+	{
+		return index >= 0 && (index == (int) code.size() || (index < (int) code.size() && starts[index]));
+	}
+
+	int size() const
+	{
+		return code.size();
+	}
+
+	int identifiers() const
+	{
+		return identTypes.size();
+	}
+
+	lexemeType identType(int ident) const
+	{
+		return identTypes[ident];
+	}
+
+	string identName(int ident) const
+	{
+		return string(identNames[ident]);
+	}
+
+	const string* strConst(int index) const
+	{
+		return &strConsts[index];
+	}
+
+	// Native function called by RPN_CALL_NATIVE with the given operand
+	const nativeFunction& native(int number) const
+	{
+		return natives->get(number);
+	}
+
+	int nativeFunctions() const
+	{
+		return natives ? natives->size() : 0;
+	}
+
+	// Function of the program called by RPN_CALL with the given operand
+	const programFunction& function(int number) const
+	{
+		return functions[number];
+	}
+
+	int programFunctions() const
+	{
+		return functions.size();
+	}
+
+	// Result of the verification of the RPN the program has been packed from
+	const verification& getCheck() const
+	{
+		return check;
+	}
+
+	// Hash of the code, the types of the identifiers and the string constants: programs with the same fingerprint
+	// behave the same
+	uint64_t getFingerprint() const
+	{
+		if (!fingerprinted)												// a replaced program (not shared between threads)
+		{
+			fingerprint = computeFingerprint();
+			fingerprinted = true;
+		}
+		return fingerprint;
+	}
+
+	// Memory taken by the code
+	size_t bytes() const
+	{
+		return code.size() * sizeof(uint32_t);
+	}
+};
@@ -0,0 +1,203 @@
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <memory>
+#include <unordered_map>
+#include <exception>
+#include "Interpreter.cpp"
+
+using namespace std;
+
+
+//___________________________________________________EMBEDDED PROGRAM__________________________________________________
+// Model language program run inside a host program, which exchanges values with it through its variables instead of
+// read() and write(): values are bound to variables (by their names) before a run, and the variables are read after
+// it. Strings go both ways as views. A bound string is not copied: the host keeps it until the run is over (a string
+// the program makes of it is its own). A string read back is a view of the run's memory, valid until the next run.
+// The program is compiled once, and may be run any number of times on the thread it has been created on
+class EmbeddedProgram
+{
+	struct hostValue
+	{
+		int value;														// int / bool value
+		string_view text;												// string value (kept by the host)
+	};
+
+	shared_ptr<const CompiledProgram> program;
+	string warnings;													// warnings of the analysis
+	unordered_map<string, int> numbers;									// numbers of the variables by name
+	unordered_map<int, hostValue> bound;								// values bound to the variables by number
+	executionOptions options;
+	Arena arena;														// memory of the runs
+	pmr::vector<variable> variables;									// variables of the last run (kept in the arena)
+	size_t keptBytes;													// capacity of their string buffers
+	bool ran;
+
+	// Number of the variable of the given type. Throws InterpreterError if the program has no such variable
+	int variableNumber(const string &name, lexemeType type) const
+	{
+		auto it = numbers.find(name);
+		if (it == numbers.end())
+			throw InterpreterError("Variable \"" + name + "\" is not declared in the program");
+		if (program->identType(it->second) != type)
+			throw InterpreterError("Variable \"" + name + "\" is not of type " +
+								   (type == LEX_INT ? "int" : type == LEX_BOOL ? "bool" : "string"));
+		return it->second;
+	}
+
+	// Value of the variable after the last run
+	const variable& valueOf(const string &name, lexemeType type) const
+	{
+		int ident = variableNumber(name, type);
+		if (!ran)
+			throw InterpreterError("The program has not been run");
+		return variables[ident];
+	}
+
+	// Let the values of the last run go before the memory they are kept in
+	void releaseVariables()
+	{
+		StringValue::setMemory(&arena, keptBytes);
+		pmr::vector<variable>(&arena).swap(variables);
+		keptBytes = 0;
+	}
+
+public:
+	// Compile the program, which may call the given functions of the host (see NativeFunctions.cpp). Throws
+	// InterpreterError if it cannot be compiled
+	EmbeddedProgram(ProgramSource source, executionOptions opts=executionOptions(),
+					shared_ptr<const NativeFunctions> natives=nullptr):
+		options(opts), variables(&arena), keptBytes(0), ran(false)
+	{
+		ostringstream messages;											// the parser's report of a successful analysis
+		ostringstream warningStream;
+		programStreams streams;
+		streams.out = &messages;
+		streams.err = &warningStream;
+		{
+			Interpreter interpreter(move(source), STREAM_INPUT, nullptr, streams);
+			interpreter.setNatives(move(natives));
+			interpreter.compile();
+			program = interpreter.share();
+		}
+		warnings = warningStream.str();
+		options.quiet = true;											// the output of a run is only the program's
+		for (int i = 0; i < program->identifiers(); i++)
+			if (program->identType(i) != LEX_NULL)						// labels are not variables
+				numbers[program->identName(i)] = i;
+	}
+
+	~EmbeddedProgram()
+	{
+		releaseVariables();
+		StringValue::setMemory(pmr::new_delete_resource());			// the thread's string values no longer use the arena
+	}
+
+	EmbeddedProgram(const EmbeddedProgram&) = delete;
+	EmbeddedProgram& operator = (const EmbeddedProgram&) = delete;
+
+	// Give the variable its value before the runs (the program's own assignments still take place)
+	void bindInt(const string &name, int value)
+	{
+		bound[variableNumber(name, LEX_INT)] = hostValue {value, {}};
+	}
+
+	void bindBool(const string &name, bool value)
+	{
+		bound[variableNumber(name, LEX_BOOL)] = hostValue {value, {}};
+	}
+
+	void bindString(const string &name, string_view value)
+	{
+		bound[variableNumber(name, LEX_STRING)] = hostValue {0, value};
+	}
+
+	void clearBindings()
+	{
+		bound.clear();
+	}
+
+	// Run the program with the bound values. Its read() and write() (if it uses them) go to the given streams.
+	// Running out of fuel, string memory or time is returned as the status. A run stopped by an error (thrown as
+	// InterpreterError) leaves the variables with the values they had when it stopped
+	executionStatus run(const programStreams &s=programStreams())
+	{
+		releaseVariables();
+		arena.reset();													// the values of the previous run are gone
+		ran = false;
+		executionStatus status;
+		try
+		{
+			status = withPolicy(options, [&](auto policy)
+			{
+				Executer<decltype(policy)> executer(arena, STREAM_INPUT, options, s);
+				executer.begin(*program);
+				auto &frame = executer.variables();
+				for (auto &[ident, value] : bound)
+				{
+					if (program->identType(ident) == LEX_STRING)
+						frame[ident].strValue = StringValue::external(value.text);
+					else
+						frame[ident].value = value.value;
+					frame[ident].assigned = true;
+				}
+				exception_ptr error;
+				try
+				{
+					executer.step();
+				}
+				catch (InterpreterError&)
+				{
+					error = current_exception();
+				}
+				variables = move(frame);								// kept for the host to read (after an error too)
+				ran = true;
+				if (error)
+					rethrow_exception(error);
+				return executer.getStatus();
+			});
+		}
+		catch (InterpreterError&)
+		{
+			keptBytes = StringValue::getLiveBytes();
+			throw;
+		}
+		keptBytes = StringValue::getLiveBytes();
+		return status;
+	}
+
+	// Values of the variables after the last run. Throws InterpreterError if the program has no such variable
+	int getInt(const string &name) const
+	{
+		return valueOf(name, LEX_INT).value;
+	}
+
+	bool getBool(const string &name) const
+	{
+		return valueOf(name, LEX_BOOL).value;
+	}
+
+	string_view getString(const string &name) const
+	{
+		return valueOf(name, LEX_STRING).strValue.view();
+	}
+
+	// Check that the variable has been given a value (by the host or by the program) in the last run
+	bool isAssigned(const string &name) const
+	{
+		auto it = numbers.find(name);
+		if (it == numbers.end())
+			throw InterpreterError("Variable \"" + name + "\" is not declared in the program");
+		return ran && variables[it->second].assigned;
+	}
+
+	const string& getWarnings() const
+	{
+		return warnings;
+	}
+
+	const CompiledProgram& getProgram() const
+	{
+		return *program;
+	}
+};
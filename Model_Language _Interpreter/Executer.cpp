@@ -1,414 +1,1266 @@
-#include <iostream>
-#include <stack>
-#include "RPN_Generator.cpp"
-
-using namespace std;
-
-
-//___________________________________________MODEL LANGUAGE PROGRAM EXECUTER___________________________________________
-class Executer
-{
-	Lexeme currLex;													// lexeme currently being executed
-    
-    stack<int> args;												// stack for int / bool arguement values
-    stack<string> strConstsStack;									// stack for string constants
-	stack<lexemeType> typesStack;									// stack for lexeme types
-	
-	// Execution error processing
-	void executionError(string errMessage)
-	{
-		cerr << "EXECUTION ERROR: " << errMessage << endl;
-		exit(1);
-	}
-	
-	// Execution warning processing
-	void executionWarning(string err)
-	{
-		try
-		{
-			throw err;
-		}
-		catch(string s)
-		{
-			cerr << "WARNING: " << s << endl << endl;
-		}
-	}
-public:
-	// Model program code execution
-	void execute(vector<Lexeme>& RPNs);
-	
-	// Executing printing command
-	void write()
-	{
-		if (!typesStack.empty())
-		{
-			int arg;
-			string s;
-			lexemeType currentType;
-			extract(typesStack, currentType);
-			switch (currentType)
-			{
-				case LEX_STRING:
-					extract(strConstsStack, s);
-					break;
-				
-				case LEX_INT: case LEX_BOOL:
-					extract(args, arg);
-					break;
-				
-				default:
-					break;
-			}
-			write();
-			switch (currentType)
-			{
-				case LEX_STRING:
-					cout << s;
-					break;
-				
-				case LEX_BOOL:
-					arg ? cout << "true" : cout << "false";
-					break;
-				
-				case LEX_INT:
-					cout << arg;
-					break;
-				
-				default:
-					break;
-			}
-		}
-	}
-};
-
-void Executer::execute(vector<Lexeme>& RPNs)
-{
-    int arg1;
-	int arg2;
-    string strConst1;
-	string strConst2;
-    
-	int index = 0;
-	int size = RPNs.size();
-	
-    cout << "Beginning execution...\n\n";
-    
-    while (index < size)
-    {	
-		currLex = RPNs[index];
-        switch (currLex.getType())
-        {
-			case RPN_LABEL:
-                args.push(currLex.getValue());
-                break;
-                
-			case RPN_ADDRESS:
-				args.push(currLex.getValue());
-				typesStack.push(identTable[currLex.getValue()].getType());
-				break;
-				
-			case LEX_NUM:
-				args.push(currLex.getValue());
-				typesStack.push(LEX_INT);
-				break;
-				
-			case LEX_TRUE: case LEX_FALSE:
-				args.push(currLex.getValue());
-				typesStack.push(LEX_BOOL);
-				break;
-                
-			case LEX_STR_CONST:
-				strConstsStack.push(strConstTable[currLex.getValue()]);
-				typesStack.push(LEX_STRING);
-				break;
- 
-            case LEX_ID:
-                arg1 = currLex.getValue();
-                if (identTable[arg1].isAssigned())
-                {
-					typesStack.push(identTable[arg1].getType());
-					if (identTable[arg1].getType() == LEX_STRING)
-						strConstsStack.push(identTable[arg1].getStringValue());
-					else
-						args.push(identTable[arg1].getValue());
-				}
-                else
-				{
-					executionError(
-						"the identificator \"" + identTable[arg1].getName() + "\" doesn't have a value"
-					);
-				}
-				break;
-				
-            case LEX_NOT:
-                extract(args, arg1);
-                args.push(!arg1);
-                break;
- 
-            case LEX_OR:
-                extract(args, arg1); 
-                extract(args, arg2);
-                args.push(arg2 || arg1);
-                typesStack.pop();
-                break;
- 
-            case LEX_AND:
-				extract(args, arg1);
-                extract(args, arg2);
-                args.push (arg2 && arg1);
-                typesStack.pop();
-                break;
-
-			case LEX_PLUS:
-				if (typesStack.top() == LEX_STRING)
-				{
-					extract(strConstsStack, strConst1);
-					extract(strConstsStack, strConst2);
-					strConstsStack.push(strConst2 + strConst1);
-				}
-				else
-				{
-					extract(args, arg1);
-					extract(args, arg2);
-					args.push(arg2 + arg1);
-				}
-				typesStack.pop(); 
-				break;
-				
-			case LEX_MINUS:
-				extract(args, arg1);
-				extract(args, arg2);
-				args.push(arg2 - arg1);
-				typesStack.pop();
-				break;
- 
-            case LEX_TIMES:
-                extract(args, arg1);
-                extract(args, arg2);
-                args.push(arg2 * arg1);
-                typesStack.pop();
-                break;
-				
-            case LEX_SLASH:
-                extract(args, arg1);
-                extract(args, arg2);
-                typesStack.pop();
-                if (arg1)
-					args.push(arg2 / arg1);
-				else
-					executionError("dividing by zero is illegal");
-				break;
-					
-			case LEX_PERCENT:
-                extract(args, arg1);
-                extract(args, arg2);
-                typesStack.pop();
-                if (arg1)
-					args.push(arg2 % arg1);
-				else
-					executionError("dividing by zero is illegal");
-				break;
-					
-			case LEX_UNARY_MINUS:
-				extract(args, arg1);
-				args.push(-1 * arg1);
-				break;
-				
-			case LEX_PP_PRE: case LEX_MM_PRE:
-			{	
-				extract(args, arg1);
-				int argValue = identTable[arg1].getValue();
-				int op = 1;
-				if (currLex.getType() == LEX_MM_PRE)
-					op = -1;
-				args.push(argValue + op);
-				identTable[arg1].setValue(argValue + op);
-				break;
-			}	
-            case LEX_EQ:
-				if (typesStack.top() == LEX_STRING)
-				{
-					extract(strConstsStack, strConst1);
-					extract(strConstsStack, strConst2);
-					args.push(strConst2 == strConst1);
-				}
-				else
-                {
-					extract(args, arg1);
-					extract(args, arg2);
-					args.push(arg2 == arg1);
-				}
-				typesStack.pop();
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
-                
-			case LEX_NOT_EQ:
-                if (typesStack.top() == LEX_STRING)
-				{
-					extract(strConstsStack, strConst1);
-					extract(strConstsStack, strConst2);
-					args.push(strConst2 != strConst1);
-				}
-				else
-                {
-					extract(args, arg1);
-					extract(args, arg2);
-					args.push(arg2 != arg1);
-				}
-				typesStack.pop();
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
- 
-            case LEX_LESS:
-				if (typesStack.top() == LEX_STRING)
-				{
-					extract(strConstsStack, strConst1);
-					extract(strConstsStack, strConst2);
-					args.push(strConst2 < strConst1);
-					//cout << args.top();
-				}
-				else
-                {
-					extract(args, arg1);
-					extract(args, arg2);
-					args.push(arg2 < arg1);
-				}
-				typesStack.pop(); 
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
- 
-            case LEX_GREATER:
-                if (typesStack.top() == LEX_STRING)
-				{
-					extract(strConstsStack, strConst1);
-					extract(strConstsStack, strConst2);
-					args.push(strConst2 > strConst1);
-				}
-				else
-                {
-					extract(args, arg1);
-					extract(args, arg2);
-					args.push(arg2 > arg1);
-				}
-				typesStack.pop(); 
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
- 
-            case LEX_LESS_EQ:
-                extract(args, arg1);
-                extract(args, arg2);
-                args.push(arg2 <= arg1);
-                typesStack.pop(); 
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
- 
-            case LEX_GREATER_EQ:
-                extract(args, arg1);
-                extract(args, arg2);
-                args.push(arg2 >= arg1);
-                typesStack.pop(); 
-				typesStack.pop();
-				typesStack.push(LEX_BOOL);
-                break;
- 
-            case LEX_ASSIGN:
-				typesStack.pop();
-				switch (typesStack.top())
-				{
-					case LEX_STRING:
-						extract(strConstsStack, strConst1);
-						extract(args, arg2);
-						identTable[arg2].setValue(strConst1);
-						break;
-					
-					case LEX_BOOL:
-						extract(args, arg1);
-						extract(args, arg2);
-						if (arg1)
-							arg1 = 1;
-						identTable[arg2].setValue(arg1);
-						break;
-					
-					case LEX_INT:
-						extract(args, arg1);
-						extract(args, arg2);
-						//cout << "\n\narg1 = " << arg1 << "   arg2 = " << identTable[arg2].getValue() << "\narg1 value = " << identTable[arg1].getValue() << "\n\n\n";
-						identTable[arg2].setValue(arg1);
-						break;
-					
-					default:
-						break;
-				}
-				typesStack.pop();
-				identTable[arg2].setAssign();
-                break;
- 
-            case RPN_GO:
-                extract(args, arg1);
-                index = arg1 - 1;
-                break;
- 
-            case RPN_FGO:
-                extract(args, arg1);
-                extract(args, arg2);
-                typesStack.pop();
-                if (!arg2)
-					index = arg1 - 1;
-                break;
- 
-            case LEX_WRITE:
-				write();
-				break;
-				
-			case LEX_WRITELINE:
-				write();
-				cout << endl;
-				break;
- 
-			case LEX_READ:
-				int inputValue;
-				extract(args, arg1);
-				switch (typesStack.top())
-				{
-					case LEX_INT:
-						//cout << "\nEnter int value for " << identTable[arg1].getName() << ": ";
-						cin >> inputValue;
-						identTable[arg1].setValue(inputValue);
-						break;
-					case LEX_STRING:
-						//cout << "\nEnter string value for " << identTable[arg1].getName() << ": ";
-						cin >> strConst1;
-						identTable[arg1].setValue(strConst1);
-						break;
-					case LEX_BOOL:
-						//cout << "\nEnter bool value for " << identTable[arg1].getName() << ": ";
-						cin >> strConst2;
-						inputValue = 0;
-						if (
-							strConst2 == "true" ||
-							isdigit(strConst2[0]) && strConst2[0] - '0' ||
-							(strConst2[0] == '+' || strConst2[0] == '-') && isdigit(strConst2[1]) && strConst2[1] - '0'
-						)
-							inputValue = 1;
-						identTable[arg1].setValue(inputValue);
-						break;
-					default:
-						break;
-				}
-				typesStack.pop();
-				identTable[arg1].setAssign();
-				break;
-
-			default:
-				executionError("unknown element");
-				break;
-		}
-		++index;
-	}
-	cout << "\nExecution complete!\n";
+#include <iostream>
+#include <vector>
+#include <type_traits>
+#include <climits>
+#include <chrono>
+#include <stdexcept>
+#include "InputReader.cpp"
+#include "Checkpoint.cpp"
+
+using namespace std;
+
+
+//___________________________________________________OPERAND STACK_____________________________________________________
+// Stack over a preallocated array without any checks: the capacity is reserved in advance (from the verifier's depths,
+// or before each instruction of a program that has not been verified)
+template <class T>
+class OperandStack
+{
+	pmr::vector<T> items;
+	size_t count;
+
+public:
+	OperandStack(pmr::memory_resource *memory): items(memory), count(0) {}
+
+	// Make room for the given number of items
+	void reserve(size_t capacity)
+	{
+		if (items.size() < capacity)
+			items.resize(max(capacity, 2 * items.size()));
+	}
+
+	void push(T item)
+	{
+		items[count++] = move(item);
+	}
+
+	void pop()
+	{
+		count--;
+		if constexpr (!is_trivially_destructible_v<T>)					// the value must not be kept alive by a free slot
+			items[count] = T();
+	}
+
+	T& top()
+	{
+		return items[count - 1];
+	}
+
+	// Item at the given depth below the top
+	T& peek(size_t depth)
+	{
+		return items[count - 1 - depth];
+	}
+
+	// The given number of items at the top, the deepest first
+	T* last(size_t number)
+	{
+		return items.data() + count - number;
+	}
+
+	// Item at the given position from the bottom
+	T& item(size_t index)
+	{
+		return items[index];
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+};
+
+
+//_________________________________________________EXECUTION POLICIES__________________________________________________
+// A policy switches the executer's checks and diagnostics on or off at compile time, so a run pays nothing for the
+// ones it does not use. Each policy adds to the previous one. Dividing by zero is an error of the language, so every
+// policy keeps that check.
+struct ProductionPolicy
+{
+	static constexpr bool boundsChecks = false;						// check the operands of every instruction (even in verified programs)
+	static constexpr bool divisionChecks = true;					// report dividing by zero as an execution error
+	static constexpr bool tracing = false;							// print every instruction executed
+	static constexpr bool opCounters = false;						// count the instructions executed by type
+	static constexpr bool fuel = false;								// charge backward jumps and calls against the fuel and the deadline
+};
+
+struct LimitedPolicy : ProductionPolicy
+{
+	static constexpr bool fuel = true;
+};
+
+struct CheckedPolicy : LimitedPolicy
+{
+	static constexpr bool boundsChecks = true;
+};
+
+struct ProfilingPolicy : CheckedPolicy
+{
+	static constexpr bool opCounters = true;
+};
+
+struct TracingPolicy : ProfilingPolicy
+{
+	static constexpr bool tracing = true;
+};
+
+
+//_________________________________________________EXECUTION OPTIONS___________________________________________________
+struct executionOptions
+{
+	bool checked;													// check the operands of every instruction
+	bool trace;														// print every instruction executed
+	bool opStats;													// report the number of instructions executed by type
+	long long fuel;													// maximum number of backward jumps and calls (0 - no limit)
+	size_t stringBytes;												// maximum memory of the string values in use (0 - no limit)
+	long long timeLimit;											// maximum execution time in milliseconds (0 - no limit)
+	bool quiet;														// do not print the beginning and the end of the execution
+	string checkpointFile;											// file the state of the run is saved to at backward jumps (empty - none)
+	long long checkpointInterval;									// minimum time between the checkpoints in milliseconds (0 - 1000)
+	bool resume;													// go on from the checkpoint file if there is one
+};
+
+
+//__________________________________________________EXECUTION STATUS___________________________________________________
+// How the execution has ended. Running out of a resource stops the program without ending the process
+enum executionStatus
+{
+	EXEC_OK,														// the program has run to its end
+	EXEC_ERROR,														// a lexical, syntax, semantic or execution error (InterpreterError)
+	EXEC_OUT_OF_FUEL,											// the program has made more backward jumps than allowed
+	EXEC_OUT_OF_MEMORY,												// the string values have taken more memory than allowed
+	EXEC_DEADLINE													// the program has run longer than allowed
+};
+
+
+//_____________________________________________________STEP RESULT_____________________________________________________
+// Why a resumable run has returned from step()
+enum stepResult
+{
+	STEP_FINISHED,													// the run is over and its status is known
+	STEP_NEEDS_INPUT												// the run has stopped at a read() with no value to take
+};
+
+
+//___________________________________________________EXECUTION ABORT___________________________________________________
+class ExecutionAbort : public runtime_error
+{
+public:
+	executionStatus status;
+
+	ExecutionAbort(executionStatus s, const string &message): runtime_error(message), status(s) {}
+};
+
+
+//______________________________________________________VARIABLE_______________________________________________________
+// Value of an identifier during a run. Every run has a frame of its own, so a program may run on several threads at once
+struct variable
+{
+	int value = -1;
+	StringValue strValue;
+	bool assigned = false;
+};
+
+
+//_____________________________________________________CALL RECORD_____________________________________________________
+// What a call of a function of the program saves of its caller to go back to it
+struct callRecord
+{
+	int position;													// instruction after the call
+	int function;													// the caller's function (-1 : none)
+	int base;														// the caller's first local variable in the frame
+	size_t typesBase;												// the caller's first item in the types stack
+};
+
+
+//___________________________________________MODEL LANGUAGE PROGRAM EXECUTER___________________________________________
+// The frame keeps the values of the identifiers, followed by the local variables of every call being made (the frames
+// of the calls are taken from the end of it and given back on return, so a call allocates nothing once the frame has
+// grown as deep as the calls go). A local variable is found by its slot from the base of the call's frame
+template <class Policy>
+class Executer
+{
+	static const int OPCODES = RPN_LOCAL_ADDRESS + 1;
+	static constexpr long long FUEL_SLICE = 1 << 12;					// backward jumps between the checks of the fuel and the deadline
+	static constexpr size_t MAX_CALL_DEPTH = 100000;				// calls that may be made at once
+
+	Lexeme currLex;													// lexeme currently being executed
+    
+    OperandStack<int> args;											// stack for int / bool arguement values
+    OperandStack<StringValue> strConstsStack;						// stack for string values
+	OperandStack<lexemeType> typesStack;							// stack for lexeme types
+	pmr::vector<variable> frame;									// values of the identifiers and the local variables
+	pmr::vector<callRecord> calls;									// calls being made, the outermost first
+	int current;													// function being run (-1 : none)
+	int base;														// its first local variable in the frame
+	const lexemeType *localTypes;									// types of its local variables
+	size_t typesBase;												// its first item in the types stack (write() takes no further)
+
+	inputMode input;												// the way read() gets its values
+	programStreams streams;
+	InputReader reader;												// block reader of stdin or of the fed input (not used in STREAM_INPUT mode)
+
+	Arena &arena;
+	const CompiledProgram *program;									// program being run (shared with other runs, never changed)
+	int position;													// instruction the run goes on from
+	size_t liveBytes;												// capacity of the run's string buffers while it is stopped
+	executionStatus status;
+
+	executionOptions options;
+	long long slice;												// backward jumps left before the next check of the limits
+	long long fuel;													// backward jumps left after the current slice
+	chrono::steady_clock::time_point deadline;
+	chrono::steady_clock::time_point nextCheckpoint;
+	long long opCounts[OPCODES];									// instructions executed by type
+	
+	// Execution error processing
+	void executionError(string errMessage)
+	{
+		throw InterpreterError("EXECUTION ERROR: " + errMessage);
+	}
+
+	// Malformed program error (only detected while running a program that has not been verified)
+	void malformedError(int index)
+	{
+		executionError("malformed program: instruction " + to_string(index) + " lacks its operands");
+	}
+	
+	// Execution warning processing
+	void executionWarning(string err)
+	{
+		*streams.err << "WARNING: " << err << endl << endl;
+	}
+	// Reading an integer value
+	int readInt()
+	{
+		if (input != STREAM_INPUT)
+			return reader.readInt();
+		int value = 0;												// stays 0 when there is no more input
+		*streams.in >> value;
+		return value;
+	}
+
+	// Reading a string value
+	StringValue readString()
+	{
+		if (input != STREAM_INPUT)
+			return StringValue(reader.readString());
+		string value;
+		*streams.in >> value;
+		return StringValue(value);
+	}
+
+	// Reading a boolean value
+	int readBool()
+	{
+		if (input != STREAM_INPUT)
+			return reader.readBool();
+		string value;
+		*streams.in >> value;
+		return InputReader::isTrue(value);
+	}
+
+	// Check that the stacks hold the operands of the instruction and have room for its results
+	void checkOperands(const CompiledProgram &program, int index);
+
+	// Check the limits when a slice of backward jumps is used up, and start the next one. The run is at a safe point:
+	// a checkpoint is saved there when one is due, or when a limit stops the run (it goes on from the jump's target)
+	void refuel(int target)
+	{
+		bool checkpoints = !options.checkpointFile.empty();
+		chrono::steady_clock::time_point now;
+		if (options.timeLimit || checkpoints)
+			now = chrono::steady_clock::now();
+		if (options.timeLimit && now >= deadline)
+		{
+			if (checkpoints)
+				saveCheckpoint(target);
+			throw ExecutionAbort(EXEC_DEADLINE, "the time limit of " + to_string(options.timeLimit) + " ms has been exceeded");
+		}
+		long long next = options.fuel ? min(FUEL_SLICE, fuel) : FUEL_SLICE;
+		if (next == 0)
+		{
+			if (checkpoints)
+				saveCheckpoint(target);
+			throw ExecutionAbort(EXEC_OUT_OF_FUEL, "the limit of " + to_string(options.fuel) + " backward jumps has been exceeded");
+		}
+		if (checkpoints && now >= nextCheckpoint)
+		{
+			saveCheckpoint(target);
+			nextCheckpoint = chrono::steady_clock::now() + checkpointInterval();
+		}
+		if (options.fuel)
+			fuel -= next;
+		slice = next - 1;											// the jump being made is charged as well
+	}
+
+	chrono::milliseconds checkpointInterval()
+	{
+		return chrono::milliseconds(options.checkpointInterval ? options.checkpointInterval : 1000);
+	}
+
+	// Save the state of the run, to go on from the given instruction
+	void saveCheckpoint(int target);
+
+	// Take the state of the run from the checkpoint file. Returns false if there is no checkpoint file
+	bool restoreCheckpoint();
+
+	// Types of the values in the frame, the identifiers' first and then the local variables' of every call. Returns
+	// false if the calls being made do not make up the frame (of a damaged checkpoint)
+	bool frameTypes(vector<lexemeType> &types);
+
+	// Name of the local variable in the slot of the function being run
+	string localName(int slot)
+	{
+		return program->identName(program->function(current).names[slot]);
+	}
+
+	// Print the instruction about to be executed and the depths of the stacks
+	void trace(int index)
+	{
+		*streams.err << "TRACE " << index << ": " << currLex
+			 << "args " << args.size() << ", strings " << strConstsStack.size() << ", types " << typesStack.size() << endl;
+	}
+
+	// Print the number of instructions executed by type
+	void printOpCounts()
+	{
+		*streams.err << "Instructions executed by type:\n";
+		for (int op = 0; op < OPCODES; op++)
+			if (opCounts[op])
+				*streams.err << "  " << op << ": " << opCounts[op] << '\n';
+	}
+
+	// Execution loop. The checked one is used for programs that have not been verified. Returns false if the run has
+	// stopped to wait for input
+	template <bool checked>
+	bool run(const CompiledProgram &program);
+
+public:
+	Executer(Arena &arena, inputMode mode=STREAM_INPUT, executionOptions opts=executionOptions(), programStreams s=programStreams()):
+		args(&arena), strConstsStack(&arena), typesStack(&arena), frame(&arena), calls(&arena), current(-1), base(0),
+		localTypes(nullptr), typesBase(0), input(mode), streams(s),
+		reader(mode == SESSION_INPUT), arena(arena), program(nullptr), position(0), liveBytes(0), status(EXEC_OK), options(opts)
+	{
+		StringValue::setMemory(&arena);								// string values of the run are kept in its arena
+		StringValue::setByteLimit(options.stringBytes);
+		slice = 0;
+		fuel = options.fuel;
+		memset(opCounts, 0, sizeof(opCounts));
+	}
+
+	~Executer()
+	{
+		StringValue::setMemory(&arena, liveBytes);					// the run's values are released into its own memory
+		StringValue::setByteLimit(0);
+	}
+
+	// Model program code execution
+	executionStatus execute(const CompiledProgram &program)
+	{
+		begin(program);
+		step();
+		return status;
+	}
+
+	// Prepare a resumable run of the program. The program must outlive the run
+	void begin(const CompiledProgram &program);
+
+	// Run the program until it ends, or (in SESSION_INPUT mode) until it reaches a read() with no value to take.
+	// Such a run may be stepped again after feeding it; runs taking turns on one thread keep their own string memory
+	stepResult step();
+
+	// Give values to the read() of a run in SESSION_INPUT mode
+	void feed(string_view text)
+	{
+		reader.feed(text);
+	}
+
+	// End the input of a run in SESSION_INPUT mode: the reads that find no more values get empty ones
+	void closeInput()
+	{
+		reader.close();
+	}
+
+	// Status of a finished run
+	executionStatus getStatus()
+	{
+		return status;
+	}
+
+	// Values of the identifiers: a host program may give some of them after begin(), and take them after the run
+	pmr::vector<variable>& variables()
+	{
+		return frame;
+	}
+	
+	// Executing printing command (the values of the function being run only)
+	void write()
+	{
+		if (typesStack.size() > typesBase)
+		{
+			int arg;
+			StringValue s;
+			lexemeType currentType;
+			extract(typesStack, currentType);
+			switch (currentType)
+			{
+				case LEX_STRING:
+					extract(strConstsStack, s);
+					break;
+				
+				case LEX_INT: case LEX_BOOL:
+					extract(args, arg);
+					break;
+				
+				default:
+					break;
+			}
+			write();
+			switch (currentType)
+			{
+				case LEX_STRING:
+					*streams.out << s;
+					break;
+				
+				case LEX_BOOL:
+					*streams.out << (arg ? "true" : "false");
+					break;
+				
+				case LEX_INT:
+					*streams.out << arg;
+					break;
+				
+				default:
+					break;
+			}
+		}
+	}
+};
+
+template <class Policy>
+void Executer<Policy>::begin(const CompiledProgram &prog)
+{
+	program = &prog;
+	position = 0;
+	frame.assign(program->identifiers(), variable());
+	calls.clear();
+	current = -1;
+	base = 0;
+	localTypes = nullptr;
+	typesBase = 0;
+	const verification &check = program->getCheck();
+	if (!Policy::boundsChecks && check.verified)					// the stacks never get deeper than the verifier has found
+	{
+		args.reserve(check.maxArgs);
+		strConstsStack.reserve(check.maxStrings);
+		typesStack.reserve(check.maxTypes);
+	}
+	nextCheckpoint = chrono::steady_clock::now() + checkpointInterval();
+	bool resumed = options.resume && !options.checkpointFile.empty() && restoreCheckpoint();
+	liveBytes = StringValue::getLiveBytes();						// the restored values count against the limit
+	if (!options.quiet)
+		*streams.out << (resumed ? "Resuming execution from the checkpoint...\n\n" : "Beginning execution...\n\n");
+}
+
+template <class Policy>
+void Executer<Policy>::saveCheckpoint(int target)
+{
+	CheckpointWriter image;
+	image.put(CHECKPOINT_MAGIC);
+	image.put(CHECKPOINT_VERSION);
+	image.put(program->getFingerprint());
+	image.put<int32_t>(target);
+	image.put<uint64_t>(calls.size());
+	for (auto &call : calls)
+	{
+		image.put<int32_t>(call.position);
+		image.put<int32_t>(call.function);
+		image.put<int32_t>(call.base);
+		image.put<uint64_t>(call.typesBase);
+	}
+	image.put<int32_t>(current);
+	image.put<int32_t>(base);
+	image.put<uint64_t>(typesBase);
+	vector<lexemeType> types;
+	frameTypes(types);
+	image.put<uint64_t>(frame.size());
+	for (size_t i = 0; i < frame.size(); i++)						// only the value of the variable's type
+	{
+		image.put<uint8_t>(frame[i].assigned);
+		if (types[i] == LEX_STRING)
+			image.putString(frame[i].strValue.view());
+		else
+			image.put<int32_t>(frame[i].value);
+	}
+	image.put<uint64_t>(args.size());
+	for (size_t i = 0; i < args.size(); i++)
+		image.put<int32_t>(args.item(i));
+	image.put<uint64_t>(typesStack.size());
+	for (size_t i = 0; i < typesStack.size(); i++)
+		image.put<int32_t>(typesStack.item(i));
+	image.put<uint64_t>(strConstsStack.size());
+	for (size_t i = 0; i < strConstsStack.size(); i++)
+		image.putString(strConstsStack.item(i).view());
+	if (!image.save(options.checkpointFile))
+		executionWarning("the checkpoint could not be written to " + options.checkpointFile);
+}
+
+template <class Policy>
+bool Executer<Policy>::restoreCheckpoint()
+{
+	CheckpointReader image;
+	const string &fileName = options.checkpointFile;
+	if (!image.load(fileName))
+		return false;
+	if (image.get<uint32_t>() != CHECKPOINT_MAGIC || image.get<uint32_t>() != CHECKPOINT_VERSION)
+		executionError("the file " + fileName + " is not a checkpoint of this interpreter");
+	if (image.get<uint64_t>() != program->getFingerprint())
+		executionError("the checkpoint " + fileName + " has been saved by another program");
+	int target = image.get<int32_t>();
+	size_t count = min<uint64_t>(image.get<uint64_t>(), MAX_CALL_DEPTH);
+	for (size_t i = 0; i < count; i++)
+	{
+		callRecord call;
+		call.position = image.get<int32_t>();
+		call.function = image.get<int32_t>();
+		call.base = image.get<int32_t>();
+		call.typesBase = image.get<uint64_t>();
+		if (!program->isJumpTarget(call.position) || (!calls.empty() && call.typesBase < calls.back().typesBase))
+			executionError("the checkpoint " + fileName + " is damaged");
+		calls.push_back(call);
+	}
+	current = image.get<int32_t>();
+	base = image.get<int32_t>();
+	typesBase = image.get<uint64_t>();
+	vector<lexemeType> types;
+	if (!frameTypes(types) || image.get<uint64_t>() != types.size() || !program->isJumpTarget(target) ||
+		(!calls.empty() && typesBase < calls.back().typesBase))
+		executionError("the checkpoint " + fileName + " is damaged");
+	localTypes = current < 0 ? nullptr : program->function(current).locals.data();
+
+	frame.resize(types.size());
+	for (size_t i = 0; i < frame.size(); i++)
+	{
+		frame[i].assigned = image.get<uint8_t>();
+		if (types[i] == LEX_STRING)
+			frame[i].strValue = StringValue(image.getString());
+		else
+			frame[i].value = image.get<int32_t>();
+	}
+	count = min<uint64_t>(image.get<uint64_t>(), image.remaining() / sizeof(int32_t));
+	args.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		args.push(image.get<int32_t>());
+	size_t strings = 0;
+	size_t values = 0;
+	count = min<uint64_t>(image.get<uint64_t>(), image.remaining() / sizeof(int32_t));
+	typesStack.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		lexemeType type = lexemeType(image.get<int32_t>());
+		typesStack.push(type);
+		(type == LEX_STRING ? strings : values)++;
+	}
+	count = min<uint64_t>(image.get<uint64_t>(), image.remaining() / sizeof(uint64_t));
+	strConstsStack.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		strConstsStack.push(StringValue(image.getString()));
+	if (!image.complete() || strConstsStack.size() > strings ||	// the stacks must fit the program (an address of a string
+		values + strings - strConstsStack.size() > args.size() ||	// variable, held during a call, is kept in the arguments)
+		typesBase > typesStack.size())
+		executionError("the checkpoint " + fileName + " is damaged");
+	const verification &check = program->getCheck();				// the call being made goes on above the restored stacks
+	args.reserve(args.size() + check.maxArgs);
+	strConstsStack.reserve(strConstsStack.size() + check.maxStrings);
+	typesStack.reserve(typesStack.size() + check.maxTypes);
+	position = target;
+	return true;
+}
+
+template <class Policy>
+bool Executer<Policy>::frameTypes(vector<lexemeType> &types)
+{
+	types.clear();
+	for (int i = 0; i < program->identifiers(); i++)
+		types.push_back(program->identType(i));
+	for (size_t k = 0; k <= calls.size(); k++)						// the function of every caller, then the current one
+	{
+		int function = k < calls.size() ? calls[k].function : current;
+		int start = k < calls.size() ? calls[k].base : base;
+		if (k == 0)													// the outermost code is outside functions
+		{
+			if (function != -1)
+				return false;
+			continue;
+		}
+		if (function < 0 || function >= program->programFunctions() || start != (int) types.size())
+			return false;
+		const vector<lexemeType> &locals = program->function(function).locals;
+		types.insert(types.end(), locals.begin(), locals.end());
+	}
+	return true;
+}
+
+template <class Policy>
+stepResult Executer<Policy>::step()
+{
+	StringValue::setMemory(&arena, liveBytes);
+	StringValue::setByteLimit(options.stringBytes);
+	deadline = chrono::steady_clock::now() + chrono::milliseconds(options.timeLimit);	// the limit is on each step
+
+	try
+	{
+		bool finished;
+		if constexpr (Policy::boundsChecks)
+			finished = run<true>(*program);
+		else if (program->getCheck().verified)
+			finished = run<false>(*program);
+		else
+			finished = run<true>(*program);
+		liveBytes = StringValue::getLiveBytes();
+		if (!finished)
+			return STEP_NEEDS_INPUT;
+	}
+	catch (ExecutionAbort &abort)
+	{
+		streams.out->flush();
+		*streams.err << "\nEXECUTION STOPPED: " << abort.what() << endl;
+		status = abort.status;
+		return STEP_FINISHED;
+	}
+	catch (StringLimitError &error)
+	{
+		streams.out->flush();
+		*streams.err << "\nEXECUTION STOPPED: " << error.what() << " (" << options.stringBytes << " bytes)" << endl;
+		status = EXEC_OUT_OF_MEMORY;
+		return STEP_FINISHED;
+	}
+
+	if (!options.checkpointFile.empty())							// a finished run is not resumed
+		remove(options.checkpointFile.c_str());
+	if (!options.quiet)
+		*streams.out << "\nExecution complete!\n";
+	if constexpr (Policy::opCounters)
+		if (options.opStats)
+			printOpCounts();
+	status = EXEC_OK;
+	return STEP_FINISHED;
+}
+
+template <class Policy>
+void Executer<Policy>::checkOperands(const CompiledProgram &program, int index)
+{
+	size_t needArgs = 0;
+	size_t needStrings = 0;
+	size_t needTypes = 0;
+	int address = -1;												// depth of an identifier's address taken by the instruction
+	int label = -1;													// depth of a jump target taken by the instruction
+	lexemeType type = typesStack.empty() ? LEX_NULL : typesStack.top();
+
+	switch (currLex.getType())
+	{
+		case RPN_LABEL: case RPN_ADDRESS: case LEX_NUM: case LEX_TRUE: case LEX_FALSE: case LEX_STR_CONST: case LEX_ID:
+		case RPN_LOAD:
+			break;
+
+		case RPN_LOCAL: case RPN_LOCAL_ADDRESS:
+			if (current < 0 || currLex.getValue() < 0 ||
+				currLex.getValue() >= (int) program.function(current).locals.size())
+				malformedError(index);
+			break;
+
+		case LEX_NOT: case LEX_UNARY_MINUS:
+			needArgs = 1;
+			break;
+
+		case LEX_OR: case LEX_AND: case LEX_MINUS: case LEX_TIMES: case LEX_SLASH: case LEX_PERCENT:
+			needArgs = 2;
+			needTypes = 1;
+			break;
+
+		case LEX_PLUS:
+			needTypes = 1;
+			if (type != LEX_STRING)
+				needArgs = 2;
+			else
+			{
+				needStrings = 2;
+				if (index + 1 < program.size() && program.opcode(index + 1) == LEX_ASSIGN)
+				{
+					needArgs = 1;										// the assigned variable is looked at
+					address = 0;
+				}
+			}
+			break;
+
+		case LEX_PP_PRE: case LEX_MM_PRE:
+			needArgs = 1;
+			address = 0;
+			break;
+
+		case LEX_EQ: case LEX_NOT_EQ: case LEX_LESS: case LEX_GREATER:
+			needTypes = 2;
+			(type == LEX_STRING ? needStrings : needArgs) = 2;
+			break;
+
+		case LEX_LESS_EQ: case LEX_GREATER_EQ:
+			needTypes = 2;
+			needArgs = 2;
+			break;
+
+		case LEX_ASSIGN:
+			needTypes = 2;
+			if (typesStack.size() < 2)
+				break;
+			switch (typesStack.peek(1))
+			{
+				case LEX_STRING:
+					needStrings = 1;
+					needArgs = 1;
+					address = 0;
+					break;
+
+				case LEX_BOOL: case LEX_INT:
+					needArgs = 2;
+					address = 1;
+					break;
+
+				default:
+					malformedError(index);
+			}
+			break;
+
+		case RPN_GO:
+			needArgs = 1;
+			label = 0;
+			break;
+
+		case RPN_FGO:
+			needArgs = 2;
+			needTypes = 1;
+			label = 0;
+			break;
+
+		case LEX_WRITE: case LEX_WRITELINE:							// write() takes every value of the function there is
+			for (size_t i = 0; i + typesBase < typesStack.size(); i++)
+				if (typesStack.peek(i) == LEX_STRING)
+					needStrings++;
+				else if (typesStack.peek(i) == LEX_INT || typesStack.peek(i) == LEX_BOOL)
+					needArgs++;
+			break;
+
+		case LEX_READ:
+			needArgs = 1;
+			needTypes = 1;
+			address = 0;
+			break;
+
+		case RPN_CALL_NATIVE:
+			if (currLex.getValue() < 0 || currLex.getValue() >= program.nativeFunctions())
+				malformedError(index);
+			needArgs = program.native(currLex.getValue()).ints;
+			needStrings = program.native(currLex.getValue()).strings;
+			needTypes = program.native(currLex.getValue()).params.size();
+			break;
+
+		case RPN_CALL:
+			if (currLex.getValue() < 0 || currLex.getValue() >= program.programFunctions())
+				malformedError(index);
+			needArgs = program.function(currLex.getValue()).ints + 1;
+			needStrings = program.function(currLex.getValue()).strings;
+			needTypes = program.function(currLex.getValue()).params;
+			label = 0;
+			break;
+
+		case RPN_RETURN:
+			if (calls.empty())
+				malformedError(index);
+			if (currLex.getValue())
+			{
+				needTypes = 1;
+				(program.function(current).result == LEX_STRING ? needStrings : needArgs) = 1;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	if (args.size() < needArgs || strConstsStack.size() < needStrings || typesStack.size() < needTypes)
+		malformedError(index);
+	if (address >= 0 && (args.peek(address) < 0 || args.peek(address) >= (int) frame.size()))
+		malformedError(index);
+	if (label >= 0 && !program.isJumpTarget(args.peek(label)))
+		malformedError(index);
+
+	args.reserve(args.size() + 1);									// an instruction pushes at most one item on each stack
+	strConstsStack.reserve(strConstsStack.size() + 1);
+	typesStack.reserve(typesStack.size() + 1);
+}
+
+template <class Policy>
+template <bool checked>
+bool Executer<Policy>::run(const CompiledProgram &program)
+{
+    int arg1;
+	int arg2;
+    StringValue strConst1;
+	StringValue strConst2;
+    
+	int index = position;
+	int size = program.size();
+    
+    while (index < size)
+    {	
+		[[maybe_unused]] int start = index;
+		currLex = program.fetch(index);
+		if constexpr (Policy::tracing)
+			if (options.trace)
+				trace(start);
+		if constexpr (Policy::opCounters)
+			opCounts[currLex.getType()]++;
+		if constexpr (checked)
+			checkOperands(program, index);
+        switch (currLex.getType())
+        {
+			case RPN_LABEL:
+                args.push(currLex.getValue());
+                break;
+                
+			case RPN_ADDRESS:
+				args.push(currLex.getValue());
+				typesStack.push(program.identType(currLex.getValue()));
+				break;
+				
+			case LEX_NUM:
+				args.push(currLex.getValue());
+				typesStack.push(LEX_INT);
+				break;
+				
+			case LEX_TRUE: case LEX_FALSE:
+				args.push(currLex.getValue());
+				typesStack.push(LEX_BOOL);
+				break;
+                
+			case LEX_STR_CONST:
+				strConstsStack.push(StringValue(program.strConst(currLex.getValue())));
+				typesStack.push(LEX_STRING);
+				break;
+ 
+            case LEX_ID:
+                arg1 = currLex.getValue();
+                if (frame[arg1].assigned)
+                {
+					typesStack.push(program.identType(arg1));
+					if (program.identType(arg1) == LEX_STRING)
+						strConstsStack.push(frame[arg1].strValue);
+					else
+						args.push(frame[arg1].value);
+				}
+                else
+				{
+					executionError(
+						"the identificator \"" + program.identName(arg1) + "\" doesn't have a value"
+					);
+				}
+				break;
+				
+			case RPN_LOCAL:											// a local variable of the call being made
+				arg1 = base + currLex.getValue();
+				if (!frame[arg1].assigned)
+					executionError("the identificator \"" + localName(currLex.getValue()) + "\" doesn't have a value");
+				typesStack.push(localTypes[currLex.getValue()]);
+				if (localTypes[currLex.getValue()] == LEX_STRING)
+					strConstsStack.push(frame[arg1].strValue);
+				else
+					args.push(frame[arg1].value);
+				break;
+
+			case RPN_LOCAL_ADDRESS:									// its address is its position in the frame
+				args.push(base + currLex.getValue());
+				typesStack.push(localTypes[currLex.getValue()]);
+				break;
+
+			case RPN_LOAD:											// the identifier is known to have a value
+				arg1 = currLex.getValue();
+				typesStack.push(program.identType(arg1));
+				if (program.identType(arg1) == LEX_STRING)
+					strConstsStack.push(frame[arg1].strValue);
+				else
+					args.push(frame[arg1].value);
+				break;
+				
+            case LEX_NOT:
+                extract(args, arg1);
+                args.push(!arg1);
+                break;
+ 
+            case LEX_OR:
+                extract(args, arg1); 
+                extract(args, arg2);
+                args.push(arg2 || arg1);
+                typesStack.pop();
+                break;
+ 
+            case LEX_AND:
+				extract(args, arg1);
+                extract(args, arg2);
+                args.push (arg2 && arg1);
+                typesStack.pop();
+                break;
+
+			case LEX_PLUS:
+				if (typesStack.top() == LEX_STRING)
+				{
+					extract(strConstsStack, strConst1);
+					extract(strConstsStack, strConst2);
+					if (											// "s = s + piece": the variable's old value is about to be replaced,
+						index + 1 < size &&							// so the left operand becomes the only owner of its buffer
+						program.opcode(index + 1) == LEX_ASSIGN &&	// and the piece is appended to it in place
+						strConst2.sharesBuffer(frame[args.top()].strValue)
+					)
+						frame[args.top()].strValue = StringValue();
+					strConst2.append(strConst1);
+					strConstsStack.push(move(strConst2));
+				}
+				else
+				{
+					extract(args, arg1);
+					extract(args, arg2);
+					args.push(arg2 + arg1);
+				}
+				typesStack.pop(); 
+				break;
+				
+			case LEX_MINUS:
+				extract(args, arg1);
+				extract(args, arg2);
+				args.push(arg2 - arg1);
+				typesStack.pop();
+				break;
+ 
+            case LEX_TIMES:
+                extract(args, arg1);
+                extract(args, arg2);
+                args.push(arg2 * arg1);
+                typesStack.pop();
+                break;
+				
+            case LEX_SLASH:
+                extract(args, arg1);
+                extract(args, arg2);
+                typesStack.pop();
+				if constexpr (Policy::divisionChecks)
+					if (!arg1)
+						executionError("dividing by zero is illegal");
+				args.push(arg2 / arg1);
+				break;
+					
+			case LEX_PERCENT:
+                extract(args, arg1);
+                extract(args, arg2);
+                typesStack.pop();
+				if constexpr (Policy::divisionChecks)
+					if (!arg1)
+						executionError("dividing by zero is illegal");
+				args.push(arg2 % arg1);
+				break;
+					
+			case LEX_UNARY_MINUS:
+				extract(args, arg1);
+				args.push(-1 * arg1);
+				break;
+				
+			case LEX_PP_PRE: case LEX_MM_PRE:
+			{	
+				extract(args, arg1);
+				int argValue = frame[arg1].value;
+				int op = 1;
+				if (currLex.getType() == LEX_MM_PRE)
+					op = -1;
+				args.push(argValue + op);
+				frame[arg1].value = argValue + op;
+				break;
+			}	
+            case LEX_EQ:
+				if (typesStack.top() == LEX_STRING)
+				{
+					extract(strConstsStack, strConst1);
+					extract(strConstsStack, strConst2);
+					args.push(strConst2 == strConst1);
+				}
+				else
+                {
+					extract(args, arg1);
+					extract(args, arg2);
+					args.push(arg2 == arg1);
+				}
+				typesStack.pop();
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+                
+			case LEX_NOT_EQ:
+                if (typesStack.top() == LEX_STRING)
+				{
+					extract(strConstsStack, strConst1);
+					extract(strConstsStack, strConst2);
+					args.push(strConst2 != strConst1);
+				}
+				else
+                {
+					extract(args, arg1);
+					extract(args, arg2);
+					args.push(arg2 != arg1);
+				}
+				typesStack.pop();
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+ 
+            case LEX_LESS:
+				if (typesStack.top() == LEX_STRING)
+				{
+					extract(strConstsStack, strConst1);
+					extract(strConstsStack, strConst2);
+					args.push(strConst2 < strConst1);
+					//cout << args.top();
+				}
+				else
+                {
+					extract(args, arg1);
+					extract(args, arg2);
+					args.push(arg2 < arg1);
+				}
+				typesStack.pop(); 
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+ 
+            case LEX_GREATER:
+                if (typesStack.top() == LEX_STRING)
+				{
+					extract(strConstsStack, strConst1);
+					extract(strConstsStack, strConst2);
+					args.push(strConst2 > strConst1);
+				}
+				else
+                {
+					extract(args, arg1);
+					extract(args, arg2);
+					args.push(arg2 > arg1);
+				}
+				typesStack.pop(); 
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+ 
+            case LEX_LESS_EQ:
+                extract(args, arg1);
+                extract(args, arg2);
+                args.push(arg2 <= arg1);
+                typesStack.pop(); 
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+ 
+            case LEX_GREATER_EQ:
+                extract(args, arg1);
+                extract(args, arg2);
+                args.push(arg2 >= arg1);
+                typesStack.pop(); 
+				typesStack.pop();
+				typesStack.push(LEX_BOOL);
+                break;
+ 
+            case LEX_ASSIGN:
+				typesStack.pop();
+				switch (typesStack.top())
+				{
+					case LEX_STRING:
+						extract(strConstsStack, strConst1);
+						extract(args, arg2);
+						frame[arg2].strValue = move(strConst1);
+						frame[arg2].assigned = true;
+						break;
+					
+					case LEX_BOOL:
+						extract(args, arg1);
+						extract(args, arg2);
+						if (arg1)
+							arg1 = 1;
+						frame[arg2].value = arg1;
+						frame[arg2].assigned = true;
+						break;
+					
+					case LEX_INT:
+						extract(args, arg1);
+						extract(args, arg2);
+						frame[arg2].value = arg1;
+						frame[arg2].assigned = true;
+						break;
+					
+					default:
+						break;
+				}
+				typesStack.pop();
+                break;
+ 
+            case RPN_GO:
+                extract(args, arg1);
+				if constexpr (Policy::fuel)									// every loop goes back through a backward jump
+					if (arg1 <= index && --slice < 0)
+						refuel(arg1);
+                index = arg1 - 1;
+                break;
+ 
+            case RPN_FGO:
+                extract(args, arg1);
+                extract(args, arg2);
+                typesStack.pop();
+                if (!arg2)
+					index = arg1 - 1;
+                break;
+ 
+            case LEX_WRITE:
+				write();
+				break;
+				
+			case LEX_WRITELINE:
+				write();
+				*streams.out << endl;
+				break;
+ 
+			case LEX_READ:
+				if (input == SESSION_INPUT && !reader.ready())		// the run stops before the read() until it is fed
+				{
+					if constexpr (Policy::opCounters)
+						opCounts[LEX_READ]--;
+					position = start;
+					return false;
+				}
+				extract(args, arg1);
+				switch (typesStack.top())
+				{
+					case LEX_INT:
+						frame[arg1].value = readInt();
+						break;
+					case LEX_STRING:
+						frame[arg1].strValue = readString();
+						break;
+					case LEX_BOOL:
+						frame[arg1].value = readBool();
+						break;
+					default:
+						break;
+				}
+				typesStack.pop();
+				frame[arg1].assigned = true;
+				break;
+
+			case RPN_CALL_NATIVE:									// the arguments are taken where they are
+			{
+				const nativeFunction &function = program.native(currLex.getValue());
+				NativeCall call(args.last(function.ints), strConstsStack.last(function.strings));
+				function.call(call);
+				for (int i = 0; i < function.ints; i++)
+					args.pop();
+				for (int i = 0; i < function.strings; i++)
+					strConstsStack.pop();
+				for (size_t i = 0; i < function.params.size(); i++)
+					typesStack.pop();
+				if (function.result == LEX_STRING)
+					strConstsStack.push(move(call.strResult));
+				else
+					args.push(call.intResult);
+				typesStack.push(function.result);
+				break;
+			}
+
+			case RPN_CALL:											// the arguments are moved to the parameters in a new frame
+			{
+				const programFunction &function = program.function(currLex.getValue());
+				extract(args, arg1);								// the function's entry
+				if (calls.size() == MAX_CALL_DEPTH)
+					executionError("the calls are nested more than " + to_string(MAX_CALL_DEPTH) + " deep");
+				int callee = frame.size();
+				frame.resize(callee + function.locals.size());
+				const int *ints = args.last(function.ints);
+				StringValue *strings = strConstsStack.last(function.strings);
+				for (int i = 0, k = 0, n = 0; i < function.params; i++)
+				{
+					variable &param = frame[callee + i];
+					if (function.locals[i] == LEX_STRING)
+						param.strValue = move(strings[n++]);
+					else
+						param.value = function.locals[i] == LEX_BOOL ? ints[k++] != 0 : ints[k++];
+					param.assigned = true;
+				}
+				for (int i = 0; i < function.ints; i++)
+					args.pop();
+				for (int i = 0; i < function.strings; i++)
+					strConstsStack.pop();
+				for (int i = 0; i < function.params; i++)
+					typesStack.pop();
+
+				calls.push_back(callRecord {index + 1, current, base, typesBase});
+				current = currLex.getValue();
+				base = callee;
+				localTypes = function.locals.data();
+				typesBase = typesStack.size();
+				if constexpr (!checked)								// the call's stacks go no deeper than the verifier has found
+				{
+					const verification &check = program.getCheck();
+					args.reserve(args.size() + check.maxArgs);
+					strConstsStack.reserve(strConstsStack.size() + check.maxStrings);
+					typesStack.reserve(typesStack.size() + check.maxTypes);
+				}
+				if constexpr (Policy::fuel)							// recursion is a loop: a call is charged like a backward jump
+					if (--slice < 0)
+						refuel(arg1);
+				index = arg1 - 1;
+				break;
+			}
+
+			case RPN_RETURN:										// the result takes the place of the call
+			{
+				lexemeType result = program.function(current).result;
+				if (!currLex.getValue())							// the end of the body: the default value
+				{
+					if (result == LEX_STRING)
+						strConstsStack.push(StringValue());
+					else
+						args.push(0);
+				}
+				else
+				{
+					if (result == LEX_BOOL && args.top())
+						args.top() = 1;
+					typesStack.pop();
+				}
+				typesStack.push(result);
+				frame.resize(base);
+				callRecord &caller = calls.back();
+				index = caller.position - 1;
+				current = caller.function;
+				base = caller.base;
+				localTypes = current < 0 ? nullptr : program.function(current).locals.data();
+				typesBase = caller.typesBase;
+				calls.pop_back();
+				break;
+			}
+
+			default:
+				executionError("unknown element");
+				break;
+		}
+		++index;
+	}
+	return true;
 }
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
+#include "Embedding.cpp"
+
+using namespace std;
+
+
+//_______________________________________________________CHECKS________________________________________________________
+// Checks of the interpreter's API as a host program uses it, which the sample programs of the tests directory cannot
+// make: every failed check is reported, and the number of them is the exit code
+int failures = 0;
+
+void check(bool passed, const string &what)
+{
+	if (!passed)
+	{
+		cerr << "FAILED: " << what << endl;
+		failures++;
+	}
+}
+
+// Check that the output ends with the values (it begins with the parser's report)
+bool endsWith(const string &text, const string &end)
+{
+	return text.size() >= end.size() && text.compare(text.size() - end.size(), end.size(), end) == 0;
+}
+
+// Output of the program run through the result cache in the directory (with the error it has ended with, if any)
+string cachedOutput(const string &text, const string &directory, const string &input="")
+{
+	istringstream in(input);
+	ostringstream out;
+	ostringstream err;
+	programStreams streams;
+	streams.in = &in;
+	streams.out = &out;
+	streams.err = &err;
+	executionOptions options = executionOptions();
+	options.quiet = true;
+	try
+	{
+		Interpreter interpreter(text, STREAM_INPUT, nullptr, streams);
+		interpreter.setOptions(options);
+		interpreter.setResultCache(directory);
+		interpreter.interpret();
+	}
+	catch (InterpreterError &error)
+	{
+		return out.str() + error.what();
+	}
+	return out.str();
+}
+
+
+//____________________________________________________RESULT CACHE_____________________________________________________
+// Programs that differ only in the names of their variables are not served each other's results
+void testResultCache()
+{
+	char directory[] = "/tmp/result_cache_XXXXXX";
+	if (!mkdtemp(directory))
+	{
+		check(false, "a directory for the result cache is made");
+		return;
+	}
+	string first = cachedOutput("program { int x; write(x); }", directory);
+	string again = cachedOutput("program { int x; write(x); }", directory);
+	string renamed = cachedOutput("program { int y; write(y); }", directory);
+	check(first.find("\"x\"") != string::npos, "the error of the run names its variable");
+	check(again == first, "a run is replayed from the cache");
+	check(renamed.find("\"y\"") != string::npos && renamed.find("\"x\"") == string::npos,
+		  "a program with a renamed variable misses the cache");
+	filesystem::remove_all(directory);
+
+	mkdtemp(directory);													// entries serving the inputs beginning with what they have read
+	auto entries = [&directory]
+	{
+		return distance(filesystem::directory_iterator(directory), filesystem::directory_iterator());
+	};
+	string reader = "program { int a; read(a); write(a * 2); }";
+	string recorded = cachedOutput(reader, directory, "5 6 7");
+	long count = entries();
+	check(endsWith(recorded, "\n10") && count == 2,
+		  "a run that has read a part of its input is recorded with the key's index");
+	check(cachedOutput(reader, directory, "5 99") == recorded && entries() == count,
+		  "a run on an input beginning with the same value is replayed");
+	check(endsWith(cachedOutput(reader, directory, "8"), "\n16") && entries() == count + 1,
+		  "a run on another input is recorded");
+	filesystem::remove_all(directory);
+}
+
+
+//_____________________________________________________SOURCE TEXT_____________________________________________________
+// Output of the program run by an interpreter given its text as a string (after the parser's report)
+template <class Text>
+string textOutput(const Text &text)
+{
+	ostringstream out;
+	programStreams streams;
+	streams.out = &out;
+	executionOptions options = executionOptions();
+	options.quiet = true;
+	Interpreter interpreter(text, STREAM_INPUT, nullptr, streams);
+	interpreter.setOptions(options);
+	interpreter.interpret();
+	return out.str();
+}
+
+// A string given to the interpreter is the program's text, never the path of a file
+void testSourceText()
+{
+	string text = "program { write(6 * 7); }";
+	try
+	{
+		string fromLiteral = textOutput("program { write(6 * 7); }");
+		string fromString = textOutput(text);
+		check(endsWith(fromLiteral, "\n42"), "program text is compiled from a string literal");
+		check(fromString == fromLiteral, "program text is compiled from a string");
+	}
+	catch (InterpreterError &error)
+	{
+		check(false, string("program text is compiled from a string: ") + error.what());
+	}
+}
+
+
+// A program file named through ProgramSource::fromFile is compiled from the file, and a session of it takes the values
+// fed to it (the way SessionInterpreter runs its program)
+void testSessionFromFile()
+{
+	char fileName[] = "/tmp/session_program_XXXXXX";
+	int fd = mkstemp(fileName);
+	if (fd < 0)
+	{
+		check(false, "a program file is made");
+		return;
+	}
+	string text = "program { int a, b; read(a); read(b); write(a + b); }";
+	bool written = write(fd, text.data(), text.size()) == (ssize_t) text.size();
+	close(fd);
+	check(written, "a program file is written");
+
+	ostringstream messages;
+	ostringstream out;
+	programStreams streams;
+	streams.out = &messages;
+	programStreams sessionStreams;
+	sessionStreams.out = &out;
+	sessionStreams.err = &out;
+	try
+	{
+		Interpreter interpreter(ProgramSource::fromFile(fileName), STREAM_INPUT, nullptr, streams);
+		executionOptions options = executionOptions();
+		options.quiet = true;
+		interpreter.setOptions(options);
+		interpreter.compile();
+		Arena arena;
+		unique_ptr<Session> session = interpreter.openSession(arena, sessionStreams);
+		bool waits = session->step() == STEP_NEEDS_INPUT;
+		session->feed("3");
+		waits = waits && session->step() == STEP_NEEDS_INPUT;
+		session->feed("4");
+		bool finished = session->step() == STEP_FINISHED;
+		check(waits && finished && session->getStatus() == EXEC_OK && out.str() == "7",
+			  "a session of a program file runs on the values fed to it");
+	}
+	catch (InterpreterError &error)
+	{
+		check(false, string("a session of a program file runs: ") + error.what());
+	}
+	unlink(fileName);
+}
+
+
+//_____________________________________________________EMBEDDING_______________________________________________________
+// Values bound by the host reach the program, and its variables are read back after the run
+void testEmbedding()
+{
+	EmbeddedProgram embedded(ProgramSource::fromMemory("program { int n, total; bool big; string name, greeting; "
+		"total = n * 2; big = total > 10; greeting = \"Hello, \" + name; }"));
+	string name = "world";
+	embedded.bindInt("n", 21);
+	embedded.bindString("name", name);
+	check(embedded.run() == EXEC_OK, "an embedded program runs");
+	check(embedded.getInt("total") == 42, "an int is read back");
+	check(embedded.getBool("big"), "a bool is read back");
+	check(embedded.getString("greeting") == "Hello, world", "a string made of a bound one is read back");
+	check(embedded.isAssigned("n") && embedded.isAssigned("greeting"), "bound and assigned variables have values");
+
+	embedded.bindInt("n", 2);
+	embedded.run();
+	check(embedded.getInt("total") == 4 && !embedded.getBool("big"), "a program is run again with other values");
+
+	bool thrown = false;
+	try
+	{
+		embedded.getInt("name");
+	}
+	catch (InterpreterError&)
+	{
+		thrown = true;
+	}
+	check(thrown, "a variable of another type is not read");
+	thrown = false;
+	try
+	{
+		embedded.bindInt("missing", 1);
+	}
+	catch (InterpreterError&)
+	{
+		thrown = true;
+	}
+	check(thrown, "a variable the program does not declare is not bound");
+}
+
+// A run stopped by an error leaves the variables with the values they had then
+void testEmbeddingError()
+{
+	EmbeddedProgram embedded(ProgramSource::fromMemory("program { int n, m; string s; s = \"kept\"; m = 7; n = n + 1; }"));
+	bool thrown = false;
+	try
+	{
+		embedded.getInt("m");
+	}
+	catch (InterpreterError&)
+	{
+		thrown = true;
+	}
+	check(thrown, "variables are not read before a run");
+
+	for (int i = 0; i < 2; i++)											// the memory of a failed run is reused by the next one
+	{
+		thrown = false;
+		try
+		{
+			embedded.run();
+		}
+		catch (InterpreterError &error)
+		{
+			thrown = string(error.what()).find("\"n\"") != string::npos;
+		}
+		check(thrown, "a run reading an unbound variable stops with an error");
+		check(embedded.getInt("m") == 7 && embedded.getString("s") == "kept",
+			  "the variables keep the values assigned before the error");
+		check(!embedded.isAssigned("n"), "an unbound variable has no value after the error");
+	}
+
+	embedded.bindInt("n", 1);
+	check(embedded.run() == EXEC_OK && embedded.getInt("n") == 2, "a bound variable lets the run finish");
+}
+
+
+//________________________________________________________READS________________________________________________________
+// Integers are read from blocks of input by the same rules as from a stream: a token with more than one sign is not one
+void testReadInt()
+{
+	InputReader reader(true);
+	reader.feed("--5 +-5 -5 +7 - x 12");
+	reader.close();
+	int expected[] = {0, 0, -5, 7, 0, 0, 12};
+	bool same = true;
+	for (int value : expected)
+		same = same && reader.readInt() == value;
+	check(same, "integers with two signs, a lone sign and words are read as 0, and the tokens are skipped");
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: HostTest
+int main()
+{
+	testResultCache();
+	testSourceText();
+	testSessionFromFile();
+	testEmbedding();
+	testEmbeddingError();
+	testReadInt();
+	if (failures)
+		cerr << failures << " checks failed" << endl;
+	else
+		cout << "All checks passed" << endl;
+	return failures;
+}
@@ -0,0 +1,398 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <unordered_map>
+#include <sstream>
+#include <cstring>
+#include "Interpreter.cpp"
+
+using namespace std;
+
+
+//_________________________________________________INCREMENTAL COMPILER________________________________________________
+// Compiler of a program that is edited between its runs (see WatchInterpreter.cpp). The program is kept as the outline
+// of its top-level statements: the text, the RPN (labels counted from the statement's first instruction), and the
+// executer's stacks and the identifiers definitely assigned after each one. A new text is compared with the old one,
+// and only the statements around the bytes that differ are scanned and parsed again: from the statement the change
+// begins in, until one ends where an old statement has ended, leaves the parser as the old one has, and is followed by
+// the same text as before. Their RPN is verified from the stacks the statement before them leaves, and the statements
+// after them are verified again only as long as the stacks or the assigned identifiers they begin with are not those
+// of before. Then the packed code of the statements is replaced, and the labels of the code after it are moved.
+// A program whose statements jump into each other (labels and goto, or calls of the functions it defines), leave
+// postfix operations to the next one or cannot be verified one statement after another is compiled whole, as is a text the statements cannot be matched in,
+// or with an error in it (the whole compilation reports the error as usual)
+class IncrementalCompiler
+{
+	struct statement
+	{
+		size_t begin;													// its text, from the end of the previous statement
+		size_t end;														//   to the end of its last lexeme
+		pmr::vector<Lexeme> rpn;
+		vector<pair<int, lexemeType>> declared;							// identifiers it declares, with their types
+		bool carriedIn;													// the parser's state it has been analysed in
+		bool carriedOut;												//   and the state it leaves (see Parser::statementOutline)
+		Verifier::state stacks;											// the executer's stacks after it
+		AssignmentAnalysis::identSet assigned;							// identifiers definitely assigned after it
+		verification check;												// verification of its RPN (the stacks' maximum depths)
+		int words;														// size of its packed code
+	};
+
+	ostringstream messages;												// the parser's report of a successful analysis
+	programStreams streams;
+	Arena arena;														// memory of the parser and of the identifiers' names
+	optional<Parser> parser;
+	string text;
+	vector<unique_ptr<statement>> statements;							// outline of the program (empty - compiled whole)
+	vector<size_t> declarations;										// end of the statement declaring each identifier (npos - none)
+	optional<CompiledProgram> program;
+	bool whole;															// indicator that the last text has been compiled whole
+	int analysed;														// statements analysed by the last compilation
+
+	// Verify the statement's RPN from the given stacks and mark its loads of the given assigned identifiers. The stacks
+	// and the identifiers are replaced with those after it. Returns false if it cannot be verified
+	static bool analyseStatement(statement &st, Verifier::state &stacks, AssignmentAnalysis::identSet &assigned)
+	{
+		for (auto &lex : st.rpn)										// the loads are marked anew
+			if (lex.getType() == RPN_LOAD)
+				lex = Lexeme(LEX_ID, lex.getValue());
+		Verifier verifier(st.rpn);
+		st.check = verifier.verify(stacks);
+		if (!st.check.verified)
+			return false;
+		AssignmentAnalysis(st.rpn, verifier).markLoads(assigned);
+		st.stacks = stacks;
+		st.assigned = assigned;
+		return true;
+	}
+
+	// Length of the common beginning (or, going backwards, ending) of the texts. Blocks are compared first, since
+	// memcmp is much faster than a loop over the characters
+	static size_t commonLength(string_view a, string_view b, bool backwards)
+	{
+		const size_t BLOCK = 256;
+		size_t length = min(a.size(), b.size());
+		a = backwards ? a.substr(a.size() - length) : a.substr(0, length);
+		b = backwards ? b.substr(b.size() - length) : b.substr(0, length);
+		size_t common = 0;
+		auto block = [&](string_view text) { return text.data() + (backwards ? length - common - BLOCK : common); };
+		while (common + BLOCK <= length && memcmp(block(a), block(b), BLOCK) == 0)
+			common += BLOCK;
+		auto next = [&](string_view text) { return text[backwards ? length - common - 1 : common]; };
+		while (common < length && next(a) == next(b))
+			common++;
+		return common;
+	}
+
+	static bool sameSets(const AssignmentAnalysis::identSet &a, const AssignmentAnalysis::identSet &b)
+	{
+		for (size_t w = 0; w < max(a.size(), b.size()); w++)			// identifiers added since are in neither
+			if ((w < a.size() ? a[w] : 0) != (w < b.size() ? b[w] : 0))
+				return false;
+		return true;
+	}
+
+	// Take the statements the parser has outlined, their text beginning at the given position. Returns false if a
+	// statement's labels lead out of it
+	bool takeOutline(size_t base, vector<unique_ptr<statement>> &taken)
+	{
+		auto &outline = parser->getOutline();
+		auto &RPNs = parser->getRPNs();
+		for (size_t i = 0; i < outline.size(); i++)
+		{
+			int rpnBegin = outline[i].rpnBegin;
+			int rpnEnd = i + 1 < outline.size() ? outline[i + 1].rpnBegin : RPNs.size();
+			auto added = make_unique<statement>();
+			statement &st = *added;
+			st.begin = base + outline[i].begin;
+			st.end = base + outline[i].end;
+			st.carriedIn = outline[i].carriedIn;
+			st.carriedOut = outline[i].carriedOut;
+			if (!outline[i].settled)									// the next one would depend on what it has left
+				return false;
+			for (int k = rpnBegin; k < rpnEnd; k++)
+			{
+				Lexeme lex = RPNs[k];
+				if (lex.getType() == RPN_LABEL)
+				{
+					if (lex.getValue() < rpnBegin || lex.getValue() > rpnEnd)
+						return false;
+					lex = Lexeme(RPN_LABEL, lex.getValue() - rpnBegin);
+				}
+				st.rpn.push_back(lex);
+			}
+			for (int ident : outline[i].declared)
+				st.declared.push_back({ident, identTable[ident].getType()});
+			taken.push_back(move(added));
+		}
+		return true;
+	}
+
+	static bool hasLabels()
+	{
+		for (auto &ident : identTable)
+			if (ident.isLabel())
+				return true;
+		return false;
+	}
+
+	// Verification of the whole program from those of its statements
+	// Verification of the program made of the statements, the maxima taken over the given ones and the program's own
+	// (an upper bound is enough for the executer's stacks)
+	verification composedCheck(const vector<unique_ptr<statement>> &checked)
+	{
+		verification check = program ? program->getCheck() : verification {true, 0, 0, 0, ""};
+		for (auto &st : checked)
+		{
+			check.maxArgs = max(check.maxArgs, st->check.maxArgs);
+			check.maxStrings = max(check.maxStrings, st->check.maxStrings);
+			check.maxTypes = max(check.maxTypes, st->check.maxTypes);
+		}
+		return check;
+	}
+
+	// RPN of the statements one after another, their labels counted from the first one
+	static pmr::vector<Lexeme> joinStatements(const vector<unique_ptr<statement>> &joined)
+	{
+		pmr::vector<Lexeme> RPNs;
+		for (auto &st : joined)
+		{
+			int offset = RPNs.size();
+			for (auto &lex : st->rpn)
+				RPNs.push_back(lex.getType() == RPN_LABEL ? Lexeme(RPN_LABEL, lex.getValue() + offset) : lex);
+		}
+		return RPNs;
+	}
+
+	// Count the sizes of the statements in the packed code, and note the identifiers they declare
+	void noteStatements(const vector<unique_ptr<statement>> &noted)
+	{
+		declarations.resize(identTable.size(), string::npos);
+		for (auto &st : noted)
+		{
+			st->words = 0;
+			for (auto &lex : st->rpn)
+				st->words += program->instructionWords(lex);
+			for (auto &decl : st->declared)
+				declarations[decl.first] = st->end;
+		}
+	}
+
+	// Compile the whole text, outlining it if its statements may be compiled one by one later
+	void compileWhole()
+	{
+		whole = true;
+		statements.clear();
+		declarations.clear();
+		program.reset();
+		parser.reset();
+		clearTables();													// identifier names are kept in the arena
+		arena.reset();
+		messages.str("");
+		parser.emplace(ProgramSource::fromMemory(text), arena, streams);
+		parser->setOutlining(true);
+		parser->analyse();
+
+		auto &RPNs = parser->getRPNs();
+		bool outlined = !hasLabels() && parser->getFunctions().empty() && takeOutline(0, statements);
+		Verifier::state stacks = Verifier::state {{}, 0, {}};
+		AssignmentAnalysis::identSet assigned;
+		for (size_t i = 0; outlined && i < statements.size(); i++)
+			outlined = analyseStatement(*statements[i], stacks, assigned);
+		analysed = statements.size();
+
+		if (!outlined)													// compiled the usual way
+		{
+			statements.clear();
+			Verifier verifier(RPNs, nullptr, &parser->getFunctions());
+			verification check = verifier.verify();
+			if (check.verified)
+				AssignmentAnalysis(RPNs, verifier).markLoads();
+			program.emplace(RPNs, check, pmr::new_delete_resource(), nullptr, parser->getFunctions());
+		}
+		else
+		{
+			program.emplace(joinStatements(statements), composedCheck(statements), pmr::new_delete_resource());
+			noteStatements(statements);
+		}
+		RPNs.clear();
+	}
+
+	// Compile the statements of the new text that differ from those of the old one. Returns false if the text has to
+	// be compiled whole
+	bool compileChanges(const string &old)
+	{
+		size_t prefix = commonLength(text, old, false);
+		size_t suffix = commonLength(text, old, true);
+		long long delta = (long long) text.size() - (long long) old.size();
+		int count = statements.size();
+		if (prefix < statements[0]->begin)								// the header has changed
+			return false;
+
+		int first = count;												// the statement the change begins in
+		if (prefix < statements.back()->end)
+			first = upper_bound(statements.begin(), statements.end(), prefix,
+								[](size_t pos, const unique_ptr<statement> &st) { return pos < st->begin; })
+					- statements.begin() - 1;
+		size_t start = first < count ? statements[first]->begin : statements.back()->end;
+		bool carried = first < count ? statements[first]->carriedIn : statements.back()->carriedOut;
+
+		auto boundary = [&](int i)										// the end of the statement before the i-th one
+		{
+			return i ? statements[i - 1]->end : statements[0]->begin;
+		};
+		int last = -1;													// the old statements [first, last) are replaced
+		auto matches = [&](size_t end, bool carried)					// the old text goes on as before from the end, and
+		{																//   is analysed in the same state
+			if (text.size() - end > suffix)
+				return false;
+			size_t oldEnd = end - delta;
+			int low = first;
+			int high = count;
+			while (low < high)
+			{
+				int middle = (low + high) / 2;
+				if (boundary(middle) < oldEnd)
+					low = middle + 1;
+				else
+					high = middle;
+			}
+			if (boundary(low) != oldEnd || (low < count && statements[low]->carriedIn != carried))
+				return false;
+			last = low;
+			return true;
+		};
+
+		for (size_t i = 0; i < declarations.size(); i++)				// the declarations from the change on are made again
+			if (declarations[i] != string::npos && declarations[i] > start)
+				identTable[i].clearDeclare();
+		try
+		{
+			parser->analyseStatements(string_view(text).substr(start), carried,
+									  [&](size_t end, bool carriedOut) { return matches(start + end, carriedOut); });
+		}
+		catch (InterpreterError &)										// e.g. the change has begun a statement before
+		{
+			return false;
+		}
+		if (parser->getOutline().empty())
+			matches(start, carried);
+		vector<unique_ptr<statement>> added;
+		if (last < 0 || hasLabels() || !parser->getFunctions().empty() || !takeOutline(start, added))
+			return false;
+
+		unordered_map<int, lexemeType> declared;						// the old declarations must have been made again
+		for (auto &st : added)
+			for (auto &decl : st->declared)
+				declared[decl.first] = decl.second;
+		for (int i = first; i < last; i++)
+			for (auto &decl : statements[i]->declared)
+				if (!declared.count(decl.first) || declared[decl.first] != decl.second)
+					return false;
+		size_t kept = boundary(last);									// the old text from here on is kept
+		for (size_t i = 0; i < declarations.size(); i++)
+			if (declarations[i] != string::npos && declarations[i] > kept)
+			{
+				if (identTable[i].isDeclared())							// declared twice now
+					return false;
+				identTable[i].setDeclare();
+			}
+
+		Verifier::state stacks = first ? statements[first - 1]->stacks : Verifier::state {{}, 0, {}};
+		AssignmentAnalysis::identSet assigned = first ? statements[first - 1]->assigned : AssignmentAnalysis::identSet();
+		for (auto &st : added)
+			if (!analyseStatement(*st, stacks, assigned))
+				return false;
+		int next = last;												// the statements after them are analysed again
+		Verifier::state oldStacks = last ? statements[last - 1]->stacks : Verifier::state {{}, 0, {}};
+		AssignmentAnalysis::identSet oldAssigned = last ? statements[last - 1]->assigned : AssignmentAnalysis::identSet();
+		while (next < count && !(stacks == oldStacks && sameSets(assigned, oldAssigned)))	// until they begin as before
+		{
+			oldStacks = statements[next]->stacks;
+			oldAssigned = statements[next]->assigned;
+			if (!analyseStatement(*statements[next], stacks, assigned))
+				return false;
+			next++;
+		}
+
+		int from = 0;													// the code of the replaced statements
+		for (int i = 0; i < first; i++)
+			from += statements[i]->words;
+		int to = from;
+		for (int i = first; i < next; i++)
+			to += statements[i]->words;
+		for (int i = last; delta && i < count; i++)						// the kept text has moved
+		{
+			statements[i]->begin += delta;
+			statements[i]->end += delta;
+		}
+		for (auto &end : declarations)
+			if (end != string::npos && end > kept)
+				end += delta;
+		for (int i = last; i < next; i++)
+			added.push_back(move(statements[i]));
+		noteStatements(added);
+		pmr::vector<Lexeme> part = joinStatements(added);
+		verification check = composedCheck(added);
+		analysed = added.size();
+		statements.erase(statements.begin() + first, statements.begin() + next);
+		statements.insert(statements.begin() + first, make_move_iterator(added.begin()), make_move_iterator(added.end()));
+		return program->replace(from, to, part, check);
+	}
+
+public:
+	// Warnings of the analysis go to the given stream
+	IncrementalCompiler(ostream &warnings): whole(true), analysed(0)
+	{
+		streams.out = &messages;
+		streams.err = &warnings;
+	}
+
+	~IncrementalCompiler()
+	{
+		parser.reset();
+		clearTables();
+	}
+
+	// Compile the new text of the program (nothing is done if it is the same). Throws InterpreterError if it cannot be
+	// compiled
+	void update(string newText)
+	{
+		if (program && newText == text)
+		{
+			whole = false;
+			analysed = 0;
+			return;
+		}
+		string old = move(text);
+		text = move(newText);
+		whole = false;
+		if (!program || statements.empty() || !compileChanges(old))
+			compileWhole();
+	}
+
+	const CompiledProgram& getProgram()
+	{
+		return *program;
+	}
+
+	// Indicator that the last text has been compiled whole
+	bool compiledWhole()
+	{
+		return whole;
+	}
+
+	// Number of statements analysed by the last compilation
+	int getAnalysed()
+	{
+		return analysed;
+	}
+
+	// Number of top-level statements of the program (0 if it is not compiled by statements)
+	int getStatements()
+	{
+		return statements.size();
+	}
+};
@@ -0,0 +1,191 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+//_____________________________________________________INPUT MODES_____________________________________________________
+enum inputMode
+{
+	STREAM_INPUT,														// read() values are extracted from the input stream one by one
+	BLOCK_INPUT,														// read() values are tokenised in place from large blocks of stdin
+	SESSION_INPUT														// read() values are fed to the executer, which stops when it has none
+};
+
+
+//____________________________________________________INPUT READER_____________________________________________________
+class InputReader
+{
+	static const size_t BLOCK_SIZE = 1 << 16;							// number of bytes requested from stdin at once
+
+	string buf;															// input buffer
+	size_t pos;															// position of the first unread character in buffer
+	size_t len;															// number of valid characters in buffer
+	bool eof;															// indicator that stdin has no more data
+	bool fed;															// indicator that the input is fed by hand instead of stdin
+
+	// Read the next block of stdin into the buffer, keeping the unread characters. The blocks are read from the file
+	// descriptor past cin, so nothing may have been read from stdin through cin before (it would be kept in its buffer)
+	bool refill()
+	{
+		if (eof || fed)													// fed input is only there once it has been fed
+			return false;
+		cout.flush();													// the prompt must be visible before blocking on input
+
+		if (pos)														// move the unread tail to the front of the buffer
+		{
+			memmove(&buf[0], &buf[pos], len - pos);
+			len -= pos;
+			pos = 0;
+		}
+		if (buf.size() - len < BLOCK_SIZE)								// a token longer than the buffer makes it grow
+			buf.resize(len + BLOCK_SIZE);
+
+		long count;
+#ifdef _WIN32
+		count = _read(0, &buf[len], BLOCK_SIZE);
+#else
+		count = read(0, &buf[len], BLOCK_SIZE);
+#endif
+		if (count <= 0)
+		{
+			eof = true;
+			return false;
+		}
+		len += count;
+		return true;
+	}
+
+	// Skip whitespace characters before the next token
+	bool skipSpaces()
+	{
+		do
+		{
+			while (pos < len && isspace((unsigned char) buf[pos]))
+				pos++;
+			if (pos < len)
+				return true;
+		}
+		while (refill());
+		return false;
+	}
+
+	// Find the end of the token starting at the current position, reading more blocks if it is cut
+	size_t tokenEnd()
+	{
+		size_t end = pos;
+		while (true)
+		{
+			while (end < len && !isspace((unsigned char) buf[end]))
+				end++;
+			if (end < len || eof)										// the token is complete
+				return end;
+			size_t offset = end - pos;									// the token may continue in the next block
+			if (!refill())
+				return pos + offset;
+			end = pos + offset;
+		}
+	}
+
+	// Get the next whitespace-delimited token. The view stays valid until the next read
+	string_view nextToken()
+	{
+		if (!skipSpaces())
+			return string_view();
+		size_t end = tokenEnd();
+		string_view token(&buf[pos], end - pos);
+		pos = end;
+		return token;
+	}
+
+public:
+	InputReader(bool isFed=false): pos(0), len(0), eof(false), fed(isFed) {}
+
+	// Add text to the fed input. A token never runs from one piece into the next
+	void feed(string_view text)
+	{
+		buf.erase(0, pos);
+		buf.resize(len - pos);
+		buf.append(text);
+		buf.push_back('\n');
+		pos = 0;
+		len = buf.size();
+	}
+
+	// End the fed input: the reads that find no more tokens get empty values, as at the end of stdin
+	void close()
+	{
+		eof = true;
+	}
+
+	// Check if a value can be read without waiting for more fed input
+	bool ready()
+	{
+		return eof || skipSpaces();
+	}
+
+	// Read an integer value (leading '+' and '-' signs are allowed)
+	int readInt()
+	{
+		if (!skipSpaces())
+			return 0;
+
+		size_t end = tokenEnd();										// make sure the whole number is in the buffer
+		const char *first = &buf[pos];
+		const char *last = &buf[0] + end;
+		bool negative = false;
+		if (*first == '+' || *first == '-')
+		{
+			negative = *first == '-';
+			first++;
+		}
+
+		if (first == last || !isdigit((unsigned char) *first))			// not a number (from_chars would take a second sign):
+		{																// skip the token
+			pos = end;
+			return 0;
+		}
+
+		long long value = 0;
+		auto result = from_chars(first, last, value);
+		pos = result.ptr - &buf[0];										// the rest of the token is left for the next read
+
+		if (negative)
+			value = -value;
+		if (result.ec == errc::result_out_of_range || value > INT_MAX)
+			return negative ? INT_MIN : INT_MAX;
+		if (value < INT_MIN)
+			return INT_MIN;
+		return value;
+	}
+
+	// Read a string value. The view stays valid until the next read
+	string_view readString()
+	{
+		return nextToken();
+	}
+
+	// Read a boolean value: "true", a nonzero digit or a signed nonzero digit mean true
+	int readBool()
+	{
+		return isTrue(nextToken());
+	}
+
+	// Check if a token denotes a true boolean value
+	static bool isTrue(string_view token)
+	{
+		return
+			token == "true" ||
+			(token.size() >= 1 && isdigit(token[0]) && token[0] - '0') ||
+			(token.size() >= 2 && (token[0] == '+' || token[0] == '-') && isdigit(token[1]) && token[1] - '0');
+	}
+};
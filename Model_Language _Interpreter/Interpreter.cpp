@@ -1,21 +1,339 @@
-#include "Executer.cpp"
-
-using namespace std;
-
-
-//_________________________________________MODEL LANGUAGE PROGRAM INTERPRETER__________________________________________
-class Interpreter
-{
-	Parser parser;
-	Executer executer;
-
-public:
-	Interpreter(const string fileName): parser(fileName) {}
-	
-	void interpret()
-	{
-        parser.analyse();                                           // Conduct lexical, syntax and semantic analysis of the code. Retreive RPN vector
-		auto RPNs = parser.getRPNs();								// Retreive RPN table of the analysed code
-		executer.execute(RPNs);	                    				// Execute the analysed code
-	}
+#include <chrono>
+#include <optional>
+#include <memory>
+#include <unistd.h>
+#include "ResultCache.cpp"
+
+using namespace std;
+
+
+//______________________________________________________RUN TIMES______________________________________________________
+struct runTimes
+{
+	chrono::steady_clock::duration lex;									// scanning (measured when timing is on)
+	chrono::steady_clock::duration parse;								// parsing, verification and packing (without scanning)
+	chrono::steady_clock::duration exec;								// execution
+};
+
+
+//___________________________________________________POLICY DISPATCH___________________________________________________
+// Call the action with the cheapest executer policy that has the requested diagnostics
+template <class Action>
+auto withPolicy(const executionOptions &options, Action action)
+{
+	if (options.trace)
+		return action(TracingPolicy());
+	if (options.opStats)
+		return action(ProfilingPolicy());
+	if (options.checked)
+		return action(CheckedPolicy());
+	if (options.fuel || options.timeLimit || !options.checkpointFile.empty())	// checkpoints are saved at the checks of the limits
+		return action(LimitedPolicy());
+	return action(ProductionPolicy());
+}
+
+
+//_______________________________________________________SESSION_______________________________________________________
+// Resumable run of a compiled program, fed with its input by the host: step() returns STEP_NEEDS_INPUT when the program
+// reaches a read() with no value to take, and goes on from there after feed(). A session holds no thread while it
+// waits, so one thread may take turns with any number of them
+class Session
+{
+public:
+	virtual ~Session() {}
+
+	virtual stepResult step() = 0;
+	virtual void feed(string_view text) = 0;
+	virtual void closeInput() = 0;										// the reads that find no more values get empty ones
+	virtual executionStatus getStatus() = 0;							// status of a finished session
+};
+
+// Session run by the executer instantiated for the given policy
+template <class Policy>
+class PolicySession : public Session
+{
+	Executer<Policy> executer;
+
+public:
+	PolicySession(const CompiledProgram &program, Arena &arena, executionOptions options, programStreams s):
+		executer(arena, SESSION_INPUT, options, s)
+	{
+		executer.begin(program);
+	}
+
+	stepResult step() override
+	{
+		return executer.step();
+	}
+
+	void feed(string_view text) override
+	{
+		executer.feed(text);
+	}
+
+	void closeInput() override
+	{
+		executer.closeInput();
+	}
+
+	executionStatus getStatus() override
+	{
+		return executer.getStatus();
+	}
+};
+
+
+//__________________________________________________EXECUTION CONTEXT__________________________________________________
+// Runs of compiled programs on one thread, one after another. A run only needs its frame of variables and its stacks:
+// they are kept in the context's arena, which is released at once when the next run begins and reuses its memory,
+// so a run starts without any analysis and with hardly any allocation. Contexts share nothing but the programs they
+// run, so any number of them may run one program at once on different threads
+class ExecutionContext
+{
+	Arena arena;
+	executionOptions options;
+	inputMode input;
+
+public:
+	ExecutionContext(executionOptions opts=executionOptions(), inputMode mode=STREAM_INPUT): options(opts), input(mode) {}
+
+	~ExecutionContext()
+	{
+		StringValue::setMemory(pmr::new_delete_resource());			// the thread's string values no longer use the arena
+	}
+
+	void setOptions(const executionOptions &opts)
+	{
+		options = opts;
+	}
+
+	// Run the program with the given streams. Running out of fuel, string memory or time is returned as the status
+	executionStatus run(const CompiledProgram &program, const programStreams &s)
+	{
+		arena.reset();													// the values of the previous run are gone
+		return withPolicy(options, [&](auto policy)
+		{
+			Executer<decltype(policy)> executer(arena, input, options, s);
+			return executer.execute(program);
+		});
+	}
+
+	// Maximum number of bytes a run has held in the arena
+	size_t getPeakMemory()
+	{
+		return arena.getPeak();
+	}
+};
+
+
+//_________________________________________MODEL LANGUAGE PROGRAM INTERPRETER__________________________________________
+class Interpreter
+{
+	// Memory of the run. It is declared first, so it is torn down after the parser and the executer are gone
+	class RunMemory
+	{
+		Arena ownArena;													// used when no arena is given to the interpreter
+
+	public:
+		Arena &arena;
+
+		RunMemory(Arena *sharedArena): arena(sharedArena ? *sharedArena : ownArena) {}
+
+		~RunMemory()
+		{
+			clearTables();												// identifier names are kept in the arena as well
+			StringValue::setMemory(pmr::new_delete_resource());
+			arena.reset();												// all the memory of the run is released at once
+		}
+	};
+
+	RunMemory memory;
+	programStreams streams;
+	Parser parser;
+	inputMode input;
+	executionOptions options;
+	runTimes times;
+	optional<CompiledProgram> program;									// kept in the arena of the interpreter
+	shared_ptr<const NativeFunctions> natives;							// functions of the host program the program may call
+	unique_ptr<ResultCache> results;									// results of earlier runs (none - every run is executed)
+
+	// Run the program through the result cache: a run recorded before on the same input is replayed without being
+	// executed, and any other one is recorded. The input is read to its end first
+	executionStatus cachedRun()
+	{
+		string text(istreambuf_iterator<char>(*streams.in), (istreambuf_iterator<char>()));
+		long long settings[] = {options.fuel, (long long) options.stringBytes, options.checked, options.trace, options.opStats,
+								options.quiet};						// the options that show in the output
+		uint64_t key = fnvHash(settings, sizeof(settings), program->getFingerprint());
+
+		ResultCache::result recorded;
+		if (!results->find(key, text, recorded))
+		{
+			istringstream in(text);
+			TeeBuf outCopy(streams.out->rdbuf());
+			TeeBuf errCopy(streams.err->rdbuf());
+			ostream out(&outCopy);
+			ostream err(&errCopy);
+			recorded = ResultCache::result();
+			try
+			{
+				recorded.status = run(memory.arena, programStreams {&in, &out, &err});
+			}
+			catch (InterpreterError &error)
+			{
+				recorded.status = EXEC_ERROR;
+				recorded.failed = true;
+				recorded.error = error.what();
+			}
+			out.flush();
+			err.flush();
+			recorded.output = outCopy.getCopy();
+			recorded.errors = errCopy.getCopy();
+			bool whole = in.fail() || in.eof();							// a read has come to the end of the input
+			size_t consumed = whole ? text.size() : min(text.size(), (size_t) in.tellg() + 1);	// with the delimiter read
+			results->add(key, string_view(text).substr(0, consumed), whole, recorded);
+		}
+		else
+		{
+			*streams.out << recorded.output << flush;
+			*streams.err << recorded.errors << flush;
+		}
+		if (recorded.failed)
+			throw InterpreterError(recorded.error);
+		return recorded.status;
+	}
+
+public:
+	// An arena may be shared by consecutive runs (one at a time): its memory is reused instead of being allocated again.
+	// Errors are thrown as InterpreterError. A program in memory (ProgramSource::fromMemory) is compiled without any
+	// file being touched
+	Interpreter(ProgramSource source, inputMode mode=STREAM_INPUT, Arena *arena=nullptr, programStreams s=programStreams()):
+		memory(arena),
+		streams(s),
+		parser(move(source), memory.arena, s),
+		input(mode),
+		options(),
+		times()
+	{}
+
+	// Interpreter of the program text, compiled where it is without any file I/O (the text must be kept until compile()).
+	// A program file is given as ProgramSource::fromFile(fileName), so no string is ever taken for a path
+	explicit Interpreter(string_view text, inputMode mode=STREAM_INPUT, Arena *arena=nullptr,
+						 programStreams s=programStreams()):
+		Interpreter(ProgramSource::fromMemory(text), mode, arena, s)
+	{}
+
+	// Set the checks and diagnostics of the execution
+	void setOptions(const executionOptions &opts)
+	{
+		options = opts;
+	}
+
+	// Let the program call the host's functions (before compile())
+	void setNatives(shared_ptr<const NativeFunctions> functions)
+	{
+		natives = move(functions);
+		parser.setNatives(natives.get());
+	}
+
+	// Keep the results of the runs in the directory, and replay the result of a run made before on the same input
+	// instead of executing the program again (only in STREAM_INPUT mode, without a time limit or checkpoints, and
+	// without native functions, which may give other results every time). The input is read to its end before the
+	// run, so a program prompting for its values gets no output until then: input typed at a terminal is not cached
+	void setResultCache(const string &directory)
+	{
+		results = make_unique<ResultCache>(directory);
+	}
+
+	// Measure the time spent in the scanner (the other times are always measured)
+	void setTiming(bool on)
+	{
+		parser.setTiming(on);
+	}
+
+	// Scan the program on a thread of its own while it is being parsed
+	void setPipelining(bool on)
+	{
+		parser.setPipelining(on);
+	}
+
+	// Scan parts of the program on the given number of threads at once (0 - one scanner)
+	void setLexingThreads(int threads)
+	{
+		parser.setLexingThreads(threads);
+	}
+
+	// Analyse the program and prepare it for execution
+	void compile()
+	{
+		auto start = chrono::steady_clock::now();
+        parser.analyse();                                           // Conduct lexical, syntax and semantic analysis of the code. Retreive RPN vector
+		auto &RPNs = parser.getRPNs();								// Retreive RPN table of the analysed code
+		Verifier verifier(RPNs, natives.get(), &parser.getFunctions());
+		verification check = verifier.verify();						// Check the stack effects of the RPN along every path
+		if (check.verified)
+			AssignmentAnalysis(RPNs, verifier).markLoads();			// Drop the checks of identifiers assigned on every path
+		program.emplace(RPNs, check, &memory.arena, natives, parser.getFunctions());	// Pack the RPN for the executer
+		RPNs.clear();
+		RPNs.shrink_to_fit();
+
+		times.lex = parser.getLexTime();
+		times.parse = chrono::steady_clock::now() - start - times.lex;
+	}
+
+	// Execute the compiled program with the given streams, keeping the values of the run in the given arena.
+	// Runs do not share anything but the compiled program, so several of them may go on at once on different threads
+	// (each one with an arena of its own)
+	executionStatus run(Arena &arena, const programStreams &s) const
+	{
+		return withPolicy(options, [&](auto policy)
+		{
+			Executer<decltype(policy)> executer(arena, input, options, s);
+			return executer.execute(*program);
+		});
+	}
+
+	// Copy of the compiled program that does not depend on the interpreter (or its arena): it may be run by execution
+	// contexts on any threads after the interpreter is gone
+	shared_ptr<const CompiledProgram> share() const
+	{
+		return make_shared<const CompiledProgram>(*program, pmr::new_delete_resource());
+	}
+
+	// Start a session of the compiled program: its read() takes the values fed to it, and its output goes to the given
+	// streams (s.in is not used). Sessions on one thread may share an arena, as long as it outlives them all
+	unique_ptr<Session> openSession(Arena &arena, const programStreams &s) const
+	{
+		return withPolicy(options, [&](auto policy) -> unique_ptr<Session>
+		{
+			return make_unique<PolicySession<decltype(policy)>>(*program, arena, options, s);
+		});
+	}
+
+	// Compile and run the program. Running out of fuel, string memory or time is returned as the status
+	executionStatus interpret()
+	{
+		compile();
+		auto start = chrono::steady_clock::now();
+		executionStatus status;
+		bool terminal = streams.in == &cin && isatty(STDIN_FILENO);	// the input is typed as the program asks for it
+		if (results && input == STREAM_INPUT && !options.timeLimit && options.checkpointFile.empty() && !natives &&
+			!terminal)
+			status = cachedRun();									// Replay the code's result, or execute and record it
+		else
+			status = run(memory.arena, streams);					// Execute the analysed code
+		times.exec = chrono::steady_clock::now() - start;
+		return status;
+	}
+
+	const runTimes& getTimes()
+	{
+		return times;
+	}
+
+	// Maximum number of bytes the run has held in its arena
+	size_t getPeakMemory()
+	{
+		return memory.arena.getPeak();
+	}
 };
\ No newline at end of file
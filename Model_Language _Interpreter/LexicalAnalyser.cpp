@@ -1,515 +1,659 @@
-#include <iostream>
-#include "Tables.cpp"
-
-using namespace std;
-
-
-//_______________________________________________________SCANNER_______________________________________________________
-class Scanner
-{
-	FILE *f;															// file descriptor of a model language program
-	
-	enum state
-	{
-		INIT,															// initial state
-		IDENT,
-		NUMBER,
-		STRING,
-		COMMENT,														// comment
-		COMMENT_STRING,													// one-line comment
-		DELIM,															// delimeter
-		NOT_EQ,															// not equal
-		FIN																// final state
-	};
-	
-	state currentState;
-	
-	static string wordTable[];											// functional words table
-	static lexemeType words[];
-	
-	static string delimTable[];											// delimeters table
-	static lexemeType delims[];
-	
-	char c;																// the current character 
-	string buf;															// buffer for the string being entered
-	int bufTop;															// position of the last non-empty character in buffer
-	
-private:
-	// Open model language program file for reading
-	void openFile(const string fileName)
-	{
-		f = fopen(fileName.c_str(), "r");
-		return;
-	}
-	
-	// Clear buffer
-	void clearBuffer()
-	{
-		bufTop = 0;
-		buf.clear();
-	}
-	
-	// Add new character in buffer
-	void addChar(char c)
-	{
-		buf.push_back(c);
-		bufTop++;
-	}
-	
-	// Check if a string in buffer is present in the lexemes list
-	int check(const string &buf, const string lexemesList[])
-	{
-		int i = 0;
-		while (!lexemesList[i].empty())
-		{
-			if (buf == lexemesList[i])									// if a string in buffer is equal to an item of the lexemes list,
-				return i + 1;											// return its position in the list
-			i++;														// else check the next item
-		}
-		return 0;														// 0 is returned if a string in buffer is not present in the lexemes list
-	}
-	
-	// Reading the next character of a model language program
-	void getChar()
-	{
-		c = fgetc(f);
-		return;
-	}
-	
-	// Pushing the current character back into the input stream
-	void ungetChar()
-	{
-		ungetc(c, f);
-		return;
-	}
-	
-	// Lexical error processing
-	void lexicalError(string err)
-	{
-		try
-		{
-			throw err;
-		}
-		catch (string token)
-		{
-			string errorMessage;
-			switch (token[0])
-			{
-				case '\\':
-					errorMessage = "1: Unknown escape sequence: " + token;
-					break;
-				
-				case '\"':
-					errorMessage = "2: Missing terminating \" character.";
-					break;
-				
-				case '!':
-					errorMessage = "3: Expected initializer before '" + token + "' token.";
-					break;
-				
-				case '\'':
-					errorMessage = "4: No match for deliminator " + token;
-					break;
-			}
-			cerr << "LEXICAL ERROR #" << errorMessage << endl;
-			exit(1);
-		}
-	}
-
-public:
-	Scanner(const string fileName)
-	{
-		openFile(fileName);
-		currentState = INIT;
-		getChar();
-	}
-	
-	~Scanner()
-	{
-		fclose(f);
-	}
-	
-	Lexeme getLexeme();
-};
-
-
-string Scanner::wordTable[] =
-{
-	"and",
-	"bool",
-	"break",
-	"case",
-	"continue",
-	"do",
-	"else",
-	"end",
-	"false",
-	"for",
-	"goto",
-	"if",
-	"int",
-	"not",
-	"of",
-	"or",
-	"program",
-	"read",
-	"string",
-	"true",
-	"while",
-	"write",
-	"writeline",
-};
-
-lexemeType Scanner::words[] =
-{
-	LEX_AND,															// 1
-	LEX_BOOL,															// 2
-	LEX_BREAK,															// 3
-	LEX_CASE,															// 4
-	LEX_CONTINUE,														// 5
-	LEX_DO,																// 6
-	LEX_ELSE,															// 7
-	LEX_END,															// 8
-	LEX_FALSE,															// 9
-	LEX_FOR,															// 10
-	LEX_GOTO,															// 11
-	LEX_IF,																// 12
-	LEX_INT,															// 13
-	LEX_NOT,															// 14
-	LEX_OF,																// 15
-	LEX_OR,																// 16
-	LEX_PROGRAM,														// 17
-	LEX_READ,															// 18
-	LEX_STRING,															// 19
-	LEX_TRUE,															// 20
-	LEX_WHILE,															// 21
-	LEX_WRITE,															// 22
-	LEX_WRITELINE,														// 23
-	LEX_FIN,															// 24
-};
-
-string Scanner::delimTable[] =
-{
-	"{",
-	"}",
-	"\"",
-	";",
-	",",
-	":",
-	"=",
-	"+",
-	"-",
-	"*",
-	"/",
-	"%",
-	"++",
-	"--",
-	"+=",
-	"-=",	
-	"(",
-	")",
-	"==",
-	">",
-	"<",
-	">=",
-	"<=",
-	"!=",
-};
-
-lexemeType Scanner::delims[] =
-{
-	LEX_LEFT_BRACE,														// 1
-	LEX_RIGHT_BRACE,													// 2
-	LEX_QUOTE,															// 3
-	LEX_SEMICOLON,														// 4
-	LEX_COMMA,															// 5
-	LEX_COLON,															// 6
-	LEX_ASSIGN,															// 7
-	LEX_PLUS,															// 8
-	LEX_MINUS,															// 9
-	LEX_TIMES,															// 10
-	LEX_SLASH,															// 11
-	LEX_PERCENT,														// 12
-	LEX_PLUS_PLUS,														// 13
-	LEX_MINUS_MINUS,													// 14
-	LEX_PLUS_ASSIGN,													// 15
-	LEX_MINUS_ASSIGN,													// 16
-	LEX_LEFT_PAREN,														// 17
-	LEX_RIGHT_PAREN,													// 18
-	LEX_EQ,																// 19
-	LEX_GREATER,														// 20
-	LEX_LESS,															// 21
-	LEX_GREATER_EQ,														// 22
-	LEX_LESS_EQ,														// 23
-	LEX_NOT_EQ,															// 24
-};
-
-Lexeme Scanner::getLexeme()
-{
-	clearBuffer();
-	int number;															// a number, encountered in the model language code
-	int lex;															// value of the current lexeme
-	
-	do
-	{
-		switch(currentState)
-		{
-			case INIT:													// Initial state:
-				if (c == ' ' || c == '\n' || c == '\r' || c == '\t')	//   if the character is space/end of the line/new line:
-					getChar();
-				else if (isalpha(c))									//   if the character is an identifier:									
-				{
-					clearBuffer();
-					addChar(c);
-					currentState = IDENT;
-					getChar();
-				}
-				else if (isdigit(c))									//   if the character is a number:
-				{
-					number = c - '0';
-					currentState = NUMBER;
-					getChar();
-				}
-				else if (c == '\"')
-				{
-					addChar(c);
-					currentState = STRING;
-					getChar();
-					lex = check(buf, delimTable);
-					return Lexeme(LEX_QUOTE, lex);
-				}     
-				else if (c == '/')                                      //   if the character is start of a comment:
-				{
-					clearBuffer();
-					addChar(c);
-					getChar();
-					switch(c)
-					{
-						case '*':                                       //     in case of multiple-line comment:
-							clearBuffer();
-							currentState = COMMENT;
-							getChar();
-							break;
-
-						case '/':                                       //     in case of one-line comment:
-							clearBuffer();
-							currentState = COMMENT_STRING;
-							getChar();
-							break;
-						
-						default:										//     in case of not a comment:
-							ungetChar();								//       return the current character back into the input stream
-							currentState = DELIM;
-							c = '/';									//       return to analysing '/' as delimeter
-							break;
-					}
-				}
-				else if (c == '!')                                      //   if the character is 'not equal' sign:
-				{
-					clearBuffer();
-					addChar(c);
-					currentState = NOT_EQ;
-					getChar();
-				}
-				else if (c == EOF)                                      //   if the character is end of file:
-				{
-					currentState = FIN;
-				}
-				else                                                    //    else: delimeter
-				{
-					clearBuffer();
-					addChar(c);
-					currentState = DELIM;
-				}
-				break;
-			
-			case IDENT:													// Identifier state:
-				lex = check(buf, wordTable);
-				if (isalpha(c) || isdigit(c))                           //   if the character is alphabetic or a number:
-				{
-					addChar(c);                                         //     add it to the buffer as a part of an identifier
-					getChar();
-				}
-				else                                                    //   else: the identifier is finalised 
-				{
-					currentState = INIT;								//     switch back to the initial state
-					if (lex)											//     if identifier in buffer has a match in a functional words table:
-						return Lexeme((lexemeType) lex, lex);			//       return its lexeme
-					else                                                //     else:
-					{
-						lex = addUniqueIdent(buf);                      //       add it to the table
-						return Lexeme(LEX_ID, lex);
-					}
-				}
-				break;
-			
-			case NUMBER:                                                // Number state
-				if (isdigit(c))                                         //   if the character is a digit:
-				{
-                    int newDigit = c - '0';
-					number = 10 * number + newDigit;                    //     make it continue the number
-					getChar();
-				}
-				else                                                    //   else: the number is finalised
-				{
-					currentState = INIT;
-					return Lexeme(LEX_NUM, number);                     //     return the number as a lexeme
-				}
-				break;
-				
-			case STRING:												// String state
-				clearBuffer();
-				if (c != '\"')											// if the character is NOT a finishing quote:
-				{
-					while (c != '\"')									//   consider each next character a part of string until a finishing quote is met
-					{
-						if (c == '\\')									//   if the character is a control character:
-						{
-							getChar();
-							switch(c)									//     check the next character
-							{
-								case 'n':								//      new line character
-									addChar('\n');
-									break;
-								
-								case '0':								//		end of line character
-									addChar('\0');
-									break;
-								
-								case 'r':								//      carriage return
-									addChar('\r');
-									break;
-								
-								case 't':								//      horizontal tab character
-									addChar('\t');
-									break;
-								
-								case '\\': case '\'': case '\"': case '\?': case '\%':// standard characters
-									addChar(c);
-									break;
-								
-								case '\n':								//	    string's continuation in the next line of the code
-									getChar();
-									while (c == '\t')					//		while the character is not horizontal tab used for code allignment:	
-										getChar();						//        get next character
-									ungetChar();						//		unget character that is not a tab
-									break;
-								
-								default:								//      wrong control character
-									string wrongToken = "\\" + string(1, c);
-									lexicalError(wrongToken);
-									break;
-							}
-						}
-						else if (c == '\n')								//   else: if the character is an end of line:
-							lexicalError("\"");							//     lexical error: no finishing quote
-						else											//    else: the character is a part of string
-							addChar(c);									//      so add it to the buffer
-						getChar();
-					}													//   when a finishing quote is met, the string is complete
-					lex = addUniqueStrConst(buf);				    	//   add the completed string to the identifiers table
-					return Lexeme(LEX_STR_CONST, lex);
-				}
-				else													// if the character is a finishing quote
-				{
-					addChar(c);
-					getChar();
-					currentState = INIT;								//   go out of the string state
-					lex = check(buf, delimTable);
-					return Lexeme(LEX_QUOTE, lex);						//   add finishing quote to the identifiers table
-				}
-				break;
-				
-			case COMMENT:                                               // Multiple-line comment state
-				addChar(c);
-				if (c == '*')
-				{
-					getChar();
-					if (c == '/')
-					{
-						addChar(c);
-						getChar();
-						currentState = INIT;
-					}
-					else
-						ungetChar();
-				}
-				if (c == EOF)
-					currentState = FIN;
-				else
-					getChar();
-				break;
-			
-			case COMMENT_STRING:                                        // One-line comment state
-				while (c != '\n' && c != EOF)
-					getChar();
-				if (c == EOF)
-					currentState = FIN;
-				else
-				{
-					getChar();
-					currentState = INIT;
-				}
-				break;
-			
-			case NOT_EQ:                                                // 'not equal' sign state
-				if (c == '=')                                           //   if the character is '='
-				{
-					addChar(c);
-					currentState = INIT;
-					getChar();
-					lex = check(buf, delimTable);
-					return Lexeme(LEX_NOT_EQ, lex);
-				}
-				else                                                    //   else: lexical error
-					lexicalError("!");
-				break;
-			
-			case DELIM:                                                 // Delimeter state:
-				char first;
-                first = c;
-				getChar();
-                char second;
-                second = c;
-				
-				// Composite delimeter analysis ("++", "--", "+=", "-=", "==", ">=", "<=")
-				if (													// Check the composite delimeter's first character
-					first == '+' ||
-					first == '-' ||
-					first == '>' ||
-					first == '<' ||
-					first == '='
-				)
-					switch(second)										// Check the composite delimeter's second character
-					{
-						case '+': case '-':
-							if (first == second)					    // Check that the composite delimeter is either "++" or "--"
-							{
-								addChar(second);
-								getChar();
-							}
-							break;
-
-						case '=':
-							addChar(second);							// '=' can be placed after any character of a composite delimeter
-							getChar();
-							break;
-						
-						default:
-							break;
-					}
-				currentState = INIT;
-				lex = check(buf, delimTable);
-				if (lex)
-					return Lexeme((lexemeType)(lex + (int)LEX_FIN), lex);
-				else
-					lexicalError("'" + buf + "'");
-				break;
-				
-			case FIN:
-				return Lexeme(LEX_FIN);
-				break;
-		}
-	}
-	while (true);
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "Tables.cpp"
+
+using namespace std;
+
+
+//__________________________________________________INTERPRETER ERROR__________________________________________________
+// Lexical, syntax, semantic or execution error. The message is the full text reported to the user
+class InterpreterError : public runtime_error
+{
+public:
+	InterpreterError(const string &message): runtime_error(message) {}
+};
+
+
+//____________________________________________________PROGRAM SOURCE___________________________________________________
+// Text of a model language program. Text in memory is scanned where it is, without a copy (it must be kept until the
+// program has been compiled); a file, given by its path or by an open descriptor (e.g. a pipe), is read at once into
+// the source's own buffer. A file that cannot be read is reported as InterpreterError
+class ProgramSource
+{
+	string buffer;														// text read from a file or handed over
+	string_view view;													// text kept by the caller
+	bool owned;															// indicator that the text is in the buffer
+
+public:
+	ProgramSource(): owned(true) {}										// empty program
+
+	static ProgramSource fromMemory(string_view text)
+	{
+		ProgramSource source;
+		source.view = text;
+		source.owned = false;
+		return source;
+	}
+
+	static ProgramSource fromString(string text)
+	{
+		ProgramSource source;
+		source.buffer = move(text);
+		return source;
+	}
+
+	// Read from the descriptor to its end (the descriptor is left open)
+	static ProgramSource fromDescriptor(int fd)
+	{
+		ProgramSource source;
+		char block[1 << 16];
+		while (true)
+		{
+			ssize_t length = read(fd, block, sizeof(block));
+			if (length == 0)
+				break;
+			if (length < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				throw InterpreterError(string("Cannot read the program: ") + strerror(errno));
+			}
+			source.buffer.append(block, length);
+		}
+		return source;
+	}
+
+	static ProgramSource fromFile(const string &fileName)
+	{
+		ifstream file(fileName);
+		if (!file)
+			throw InterpreterError("Cannot open the program file " + fileName);
+		ProgramSource source;
+		source.buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+		if (file.bad())
+			throw InterpreterError("Cannot read the program file " + fileName);
+		return source;
+	}
+
+	string_view getText() const
+	{
+		return owned ? string_view(buffer) : view;
+	}
+};
+
+
+//_______________________________________________________SCANNER_______________________________________________________
+class Scanner
+{
+	ProgramSource source;												// the program (its text is read at once)
+	string_view text;													// the text being scanned (the program or a part of it)
+	size_t pos;															// position of the next character in the text
+	pmr::memory_resource *memory;										// memory of the run (identifier names are kept there)
+	
+	enum state
+	{
+		INIT,															// initial state
+		IDENT,
+		NUMBER,
+		STRING,
+		COMMENT,														// comment
+		COMMENT_STRING,													// one-line comment
+		DELIM,															// delimeter
+		NOT_EQ,															// not equal
+		FIN																// final state
+	};
+	
+	state currentState;
+	
+	static string wordTable[];											// functional words table
+	static lexemeType words[];
+	
+	static string delimTable[];											// delimeters table
+	static lexemeType delims[];
+	
+	char c;																// the current character 
+	string buf;															// buffer for the string being entered
+	int bufTop;															// position of the last non-empty character in buffer
+	bool keepBuffer;													// indicator that the next lexeme goes on with the buffer (a comment is pending)
+
+	bool deferred;														// indicator that the tables are filled by the scanner's consumer
+	unordered_map<string, int> idents;									// numbers given to the identifiers (deferred tables)
+	unordered_map<string, int> strConsts;								// numbers given to the string constants (deferred tables)
+	bool newSymbol;														// indicator that the last lexeme is the first one of its symbol
+	
+private:
+	// Clear buffer
+	void clearBuffer()
+	{
+		bufTop = 0;
+		buf.clear();
+	}
+	
+	// Add new character in buffer
+	void addChar(char c)
+	{
+		buf.push_back(c);
+		bufTop++;
+	}
+	
+	// Check if a string in buffer is present in the lexemes list
+	int check(const string &buf, const string lexemesList[])
+	{
+		int i = 0;
+		while (!lexemesList[i].empty())
+		{
+			if (buf == lexemesList[i])									// if a string in buffer is equal to an item of the lexemes list,
+				return i + 1;											// return its position in the list
+			i++;														// else check the next item
+		}
+		return 0;														// 0 is returned if a string in buffer is not present in the lexemes list
+	}
+	
+	// Number an identifier or a string constant in the order of their first appearance, as the tables do.
+	// With deferred tables, a symbol seen for the first time is left in the buffer for the consumer to add
+	int addSymbol(unordered_map<string, int> &numbers)
+	{
+		auto [it, added] = numbers.emplace(buf, numbers.size());
+		newSymbol = added;
+		return it->second;
+	}
+
+	// Reading the next character of a model language program
+	void getChar()
+	{
+		c = pos < text.size() ? text[pos] : EOF;						// the position goes past the end, so that EOF may be pushed back too
+		pos++;
+		return;
+	}
+	
+	// Pushing the current character back into the input stream
+	void ungetChar()
+	{
+		pos--;
+		return;
+	}
+	
+	// Lexical error processing
+	void lexicalError(string err)
+	{
+		try
+		{
+			throw err;
+		}
+		catch (string token)
+		{
+			string errorMessage;
+			switch (token[0])
+			{
+				case '\\':
+					errorMessage = "1: Unknown escape sequence: " + token;
+					break;
+				
+				case '\"':
+					errorMessage = "2: Missing terminating \" character.";
+					break;
+				
+				case '!':
+					errorMessage = "3: Expected initializer before '" + token + "' token.";
+					break;
+				
+				case '\'':
+					errorMessage = "4: No match for deliminator " + token;
+					break;
+			}
+			throw InterpreterError("LEXICAL ERROR #" + errorMessage);
+		}
+	}
+
+public:
+	Scanner(ProgramSource program, pmr::memory_resource *runMemory):
+		source(move(program)), text(source.getText()), pos(0), memory(runMemory), keepBuffer(false), deferred(false),
+		newSymbol(false)
+	{
+		currentState = INIT;
+		getChar();
+	}
+
+	// Scanner of a part of a program that starts at the beginning of a line: in the code or inside a /* */ comment.
+	// The text of a comment stays in the buffer until the next lexeme, so the part has to know if one is pending
+	Scanner(string_view part, bool inComment, bool afterComment, pmr::memory_resource *runMemory):
+		text(part), pos(0), memory(runMemory), deferred(false), newSymbol(false)
+	{
+		currentState = inComment ? COMMENT : INIT;
+		keepBuffer = inComment || afterComment;
+		if (keepBuffer)
+			buf = "*/";													// stands for the comment before the part
+		getChar();
+	}
+
+	// Text of the program
+	string_view getText()
+	{
+		return text;
+	}
+
+	// Position in the text right after the last lexeme
+	size_t offset()
+	{
+		return min(pos - 1, text.size());
+	}
+
+	// Number the symbols without touching the tables, so that the scanner may run on a thread of its own. Must be
+	// set before the first lexeme: the consumer adds every new symbol (see takeNewSymbol) to the tables in order
+	void deferTables()
+	{
+		deferred = true;
+	}
+
+	// Get the name of the identifier or the text of the string constant the last lexeme has seen for the first time
+	bool takeNewSymbol(string &symbol)
+	{
+		if (!newSymbol)
+			return false;
+		symbol = buf;
+		newSymbol = false;
+		return true;
+	}
+
+	pmr::memory_resource* getMemory()
+	{
+		return memory;
+	}
+	
+	Lexeme getLexeme();
+};
+
+
+string Scanner::wordTable[] =
+{
+	"and",
+	"bool",
+	"break",
+	"case",
+	"continue",
+	"do",
+	"else",
+	"end",
+	"false",
+	"for",
+	"goto",
+	"if",
+	"int",
+	"not",
+	"of",
+	"or",
+	"program",
+	"read",
+	"string",
+	"true",
+	"while",
+	"write",
+	"writeline",
+	"return",
+	""																	// end of the table
+};
+
+lexemeType Scanner::words[] =
+{
+	LEX_AND,															// 1
+	LEX_BOOL,															// 2
+	LEX_BREAK,															// 3
+	LEX_CASE,															// 4
+	LEX_CONTINUE,														// 5
+	LEX_DO,																// 6
+	LEX_ELSE,															// 7
+	LEX_END,															// 8
+	LEX_FALSE,															// 9
+	LEX_FOR,															// 10
+	LEX_GOTO,															// 11
+	LEX_IF,																// 12
+	LEX_INT,															// 13
+	LEX_NOT,															// 14
+	LEX_OF,																// 15
+	LEX_OR,																// 16
+	LEX_PROGRAM,														// 17
+	LEX_READ,															// 18
+	LEX_STRING,															// 19
+	LEX_TRUE,															// 20
+	LEX_WHILE,															// 21
+	LEX_WRITE,															// 22
+	LEX_WRITELINE,														// 23
+	LEX_RETURN,															// 24
+};
+
+string Scanner::delimTable[] =
+{
+	"{",
+	"}",
+	"\"",
+	";",
+	",",
+	":",
+	"=",
+	"+",
+	"-",
+	"*",
+	"/",
+	"%",
+	"++",
+	"--",
+	"+=",
+	"-=",	
+	"(",
+	")",
+	"==",
+	">",
+	"<",
+	">=",
+	"<=",
+	"!=",
+	""																	// end of the table
+};
+
+lexemeType Scanner::delims[] =
+{
+	LEX_LEFT_BRACE,														// 1
+	LEX_RIGHT_BRACE,													// 2
+	LEX_QUOTE,															// 3
+	LEX_SEMICOLON,														// 4
+	LEX_COMMA,															// 5
+	LEX_COLON,															// 6
+	LEX_ASSIGN,															// 7
+	LEX_PLUS,															// 8
+	LEX_MINUS,															// 9
+	LEX_TIMES,															// 10
+	LEX_SLASH,															// 11
+	LEX_PERCENT,														// 12
+	LEX_PLUS_PLUS,														// 13
+	LEX_MINUS_MINUS,													// 14
+	LEX_PLUS_ASSIGN,													// 15
+	LEX_MINUS_ASSIGN,													// 16
+	LEX_LEFT_PAREN,														// 17
+	LEX_RIGHT_PAREN,													// 18
+	LEX_EQ,																// 19
+	LEX_GREATER,														// 20
+	LEX_LESS,															// 21
+	LEX_GREATER_EQ,														// 22
+	LEX_LESS_EQ,														// 23
+	LEX_NOT_EQ,															// 24
+};
+
+Lexeme Scanner::getLexeme()
+{
+	if (keepBuffer)														// the lexeme started before the part being scanned
+		keepBuffer = false;
+	else
+		clearBuffer();
+	int number;															// a number, encountered in the model language code
+	int lex;															// value of the current lexeme
+	
+	do
+	{
+		switch(currentState)
+		{
+			case INIT:													// Initial state:
+				if (c == ' ' || c == '\n' || c == '\r' || c == '\t')	//   if the character is space/end of the line/new line:
+					getChar();
+				else if (isalpha(c))									//   if the character is an identifier:									
+				{
+					clearBuffer();
+					addChar(c);
+					currentState = IDENT;
+					getChar();
+				}
+				else if (isdigit(c))									//   if the character is a number:
+				{
+					number = c - '0';
+					currentState = NUMBER;
+					getChar();
+				}
+				else if (c == '\"')
+				{
+					addChar(c);
+					currentState = STRING;
+					getChar();
+					lex = check(buf, delimTable);
+					return Lexeme(LEX_QUOTE, lex);
+				}     
+				else if (c == '/')                                      //   if the character is start of a comment:
+				{
+					clearBuffer();
+					addChar(c);
+					getChar();
+					switch(c)
+					{
+						case '*':                                       //     in case of multiple-line comment:
+							clearBuffer();
+							currentState = COMMENT;
+							getChar();
+							break;
+
+						case '/':                                       //     in case of one-line comment:
+							clearBuffer();
+							currentState = COMMENT_STRING;
+							getChar();
+							break;
+						
+						default:										//     in case of not a comment:
+							ungetChar();								//       return the current character back into the input stream
+							currentState = DELIM;
+							c = '/';									//       return to analysing '/' as delimeter
+							break;
+					}
+				}
+				else if (c == '!')                                      //   if the character is 'not equal' sign:
+				{
+					clearBuffer();
+					addChar(c);
+					currentState = NOT_EQ;
+					getChar();
+				}
+				else if (c == EOF)                                      //   if the character is end of file:
+				{
+					currentState = FIN;
+				}
+				else                                                    //    else: delimeter
+				{
+					clearBuffer();
+					addChar(c);
+					currentState = DELIM;
+				}
+				break;
+			
+			case IDENT:													// Identifier state:
+				lex = check(buf, wordTable);
+				if (isalpha(c) || isdigit(c))                           //   if the character is alphabetic or a number:
+				{
+					addChar(c);                                         //     add it to the buffer as a part of an identifier
+					getChar();
+				}
+				else                                                    //   else: the identifier is finalised 
+				{
+					currentState = INIT;								//     switch back to the initial state
+					if (lex)											//     if identifier in buffer has a match in a functional words table:
+						return Lexeme(words[lex - 1], lex);				//       return its lexeme
+					else                                                //     else:
+					{
+						lex = deferred ? addSymbol(idents) : addUniqueIdent(buf, memory);	//       add it to the table
+						return Lexeme(LEX_ID, lex);
+					}
+				}
+				break;
+			
+			case NUMBER:                                                // Number state
+				if (isdigit(c))                                         //   if the character is a digit:
+				{
+                    int newDigit = c - '0';
+					number = 10 * number + newDigit;                    //     make it continue the number
+					getChar();
+				}
+				else                                                    //   else: the number is finalised
+				{
+					currentState = INIT;
+					return Lexeme(LEX_NUM, number);                     //     return the number as a lexeme
+				}
+				break;
+				
+			case STRING:												// String state
+				clearBuffer();
+				if (c != '\"')											// if the character is NOT a finishing quote:
+				{
+					while (c != '\"')									//   consider each next character a part of string until a finishing quote is met
+					{
+						if (c == '\\')									//   if the character is a control character:
+						{
+							getChar();
+							switch(c)									//     check the next character
+							{
+								case 'n':								//      new line character
+									addChar('\n');
+									break;
+								
+								case '0':								//		end of line character
+									addChar('\0');
+									break;
+								
+								case 'r':								//      carriage return
+									addChar('\r');
+									break;
+								
+								case 't':								//      horizontal tab character
+									addChar('\t');
+									break;
+								
+								case '\\': case '\'': case '\"': case '\?': case '\%':// standard characters
+									addChar(c);
+									break;
+								
+								case '\n':								//	    string's continuation in the next line of the code
+									getChar();
+									while (c == '\t')					//		while the character is not horizontal tab used for code allignment:	
+										getChar();						//        get next character
+									ungetChar();						//		unget character that is not a tab
+									break;
+								
+								default:								//      wrong control character
+									string wrongToken = "\\" + string(1, c);
+									lexicalError(wrongToken);
+									break;
+							}
+						}
+						else if (c == '\n' || c == EOF)					//   else: if the character is an end of line:
+							lexicalError("\"");							//     lexical error: no finishing quote
+						else											//    else: the character is a part of string
+							addChar(c);									//      so add it to the buffer
+						getChar();
+					}													//   when a finishing quote is met, the string is complete
+					lex = deferred ? addSymbol(strConsts) : addUniqueStrConst(buf);	//   add the completed string to the identifiers table
+					return Lexeme(LEX_STR_CONST, lex);
+				}
+				else													// if the character is a finishing quote
+				{
+					addChar(c);
+					getChar();
+					currentState = INIT;								//   go out of the string state
+					lex = check(buf, delimTable);
+					return Lexeme(LEX_QUOTE, lex);						//   add finishing quote to the identifiers table
+				}
+				break;
+				
+			case COMMENT:                                               // Multiple-line comment state
+				addChar(c);
+				if (c == '*')
+				{
+					getChar();
+					if (c == '/')
+					{
+						addChar(c);
+						getChar();
+						currentState = INIT;
+					}
+					else
+						ungetChar();
+				}
+				if (c == EOF)
+					currentState = FIN;
+				else
+					getChar();
+				break;
+			
+			case COMMENT_STRING:                                        // One-line comment state
+				while (c != '\n' && c != EOF)
+					getChar();
+				if (c == EOF)
+					currentState = FIN;
+				else
+				{
+					getChar();
+					currentState = INIT;
+				}
+				break;
+			
+			case NOT_EQ:                                                // 'not equal' sign state
+				if (c == '=')                                           //   if the character is '='
+				{
+					addChar(c);
+					currentState = INIT;
+					getChar();
+					lex = check(buf, delimTable);
+					return Lexeme(LEX_NOT_EQ, lex);
+				}
+				else                                                    //   else: lexical error
+					lexicalError("!");
+				break;
+			
+			case DELIM:                                                 // Delimeter state:
+				char first;
+                first = c;
+				getChar();
+                char second;
+                second = c;
+				
+				// Composite delimeter analysis ("++", "--", "+=", "-=", "==", ">=", "<=")
+				if (													// Check the composite delimeter's first character
+					first == '+' ||
+					first == '-' ||
+					first == '>' ||
+					first == '<' ||
+					first == '='
+				)
+					switch(second)										// Check the composite delimeter's second character
+					{
+						case '+': case '-':
+							if (first == second)					    // Check that the composite delimeter is either "++" or "--"
+							{
+								addChar(second);
+								getChar();
+							}
+							break;
+
+						case '=':
+							addChar(second);							// '=' can be placed after any character of a composite delimeter
+							getChar();
+							break;
+						
+						default:
+							break;
+					}
+				currentState = INIT;
+				lex = check(buf, delimTable);
+				if (lex)
+					return Lexeme((lexemeType)(lex + (int)LEX_FIN), lex);
+				else
+					lexicalError("'" + buf + "'");
+				break;
+				
+			case FIN:
+				return Lexeme(LEX_FIN);
+				break;
+		}
+	}
+	while (true);
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include "ServerProtocol.cpp"
+
+using namespace std;
+
+
+//_______________________________________________________REQUEST_______________________________________________________
+struct requestResult
+{
+	bool delivered;														// indicator that the whole response has come
+	int status;
+	string output;
+	string errors;
+	chrono::steady_clock::duration latency;								// from connecting to the end of the response
+};
+
+// Send one request to the server and take its response
+requestResult sendRequest(const string &socketPath, const string &program, bool byPath, const string &input)
+{
+	requestResult result = requestResult();
+	auto start = chrono::steady_clock::now();
+	int fd = connectTo(socketPath);
+	if (fd < 0)
+		return result;
+	if (sendFrame(fd, byPath ? "PATH" : "SOURCE", program) && sendFrame(fd, "INPUT", input))
+	{
+		FrameReader reader(fd);
+		string tag;
+		string data;
+		while (reader.next(tag, data))
+		{
+			if (tag == "OUT")
+				result.output += data;
+			else if (tag == "ERR")
+				result.errors += data;
+			else if (tag == "STATUS")
+			{
+				result.status = atoi(data.c_str());
+				result.delivered = true;
+				break;
+			}
+		}
+	}
+	close(fd);
+	result.latency = chrono::steady_clock::now() - start;
+	return result;
+}
+
+double milliseconds(chrono::steady_clock::duration d)
+{
+	return chrono::duration<double, milli>(d).count();
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: LoadClient [--socket PATH] [--requests N] [--concurrency N] [--input FILE] [--path] [--echo] program
+// Sends the program to the server the given number of times from concurrent connections, and reports the latencies
+// and the throughput. With --echo, prints the response of the first request
+int main(int argc, char *argv[])
+{
+	string socketPath = "/tmp/model_interpreter.sock";
+	string fileName;
+	string inputName;
+	long requests = 1000;
+	int concurrency = 4;
+	bool byPath = false;
+	bool echo = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--socket" && i + 1 < argc)
+			socketPath = argv[++i];
+		else if (arg == "--requests" && i + 1 < argc)
+			requests = max(1L, atol(argv[++i]));
+		else if (arg == "--concurrency" && i + 1 < argc)				// connections open at once
+			concurrency = max(1, atoi(argv[++i]));
+		else if (arg == "--input" && i + 1 < argc)						// values for the program's read()
+			inputName = argv[++i];
+		else if (arg == "--path")										// send the program's path instead of its text
+			byPath = true;
+		else if (arg == "--echo")
+			echo = true;
+		else
+			fileName = arg;
+	}
+	if (fileName.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--socket PATH] [--requests N] [--concurrency N] [--input FILE] [--path] "
+			 << "[--echo] program\n";
+		return 1;
+	}
+
+	string program = fileName;
+	if (!byPath)
+	{
+		ifstream file(fileName);
+		if (!file)
+		{
+			cerr << "Cannot open " << fileName << endl;
+			return 1;
+		}
+		program.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+	string input;
+	if (!inputName.empty())
+	{
+		ifstream file(inputName);
+		input.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+
+	requestResult first = sendRequest(socketPath, program, byPath, input);	// also fills the server's cache
+	if (!first.delivered)
+	{
+		cerr << "No response from " << socketPath << endl;
+		return 1;
+	}
+	if (echo)
+		cout << first.output << first.errors << "[status " << first.status << "]" << endl;
+
+	vector<chrono::steady_clock::duration> latencies(requests);
+	atomic<long> next(0);
+	atomic<long> failed(0);
+	auto client = [&]
+	{
+		for (long i = next++; i < requests; i = next++)
+		{
+			requestResult result = sendRequest(socketPath, program, byPath, input);
+			latencies[i] = result.latency;
+			if (!result.delivered || result.status != first.status)
+				failed++;
+		}
+	};
+
+	auto start = chrono::steady_clock::now();
+	vector<thread> clients;
+	for (int i = 0; i < concurrency; i++)
+		clients.emplace_back(client);
+	for (auto &t : clients)
+		t.join();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) { return milliseconds(latencies[min<long>(requests - 1, p * requests)]); };
+	cout << fixed << setprecision(3) << requests << " requests (" << failed << " failed) from " << concurrency
+		 << " connections in " << seconds << " s: " << requests / seconds << " requests/s\n"
+		 << "latency p50 " << percentile(0.5) << " ms, p99 " << percentile(0.99) << " ms, max "
+		 << milliseconds(latencies.back()) << " ms\n";
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <type_traits>
+#include "ChunkedLexer.cpp"
+
+using namespace std;
+
+
+//____________________________________________________NATIVE CALL______________________________________________________
+// Arguments and result of a call of a native function. The arguments are where the executer keeps them: the int / bool
+// ones on its arguments stack and the strings on its string values stack, each in the order of the parameters
+class NativeCall
+{
+	const int *ints;													// the first int / bool argument
+	const StringValue *strings;											// the first string argument
+
+public:
+	int intResult;														// int / bool result
+	StringValue strResult;												// string result
+
+	NativeCall(const int *intArgs, const StringValue *strArgs): ints(intArgs), strings(strArgs), intResult(0) {}
+
+	// Argument at the given position among those kept like it
+	template <class T>
+	T argument(int slot) const
+	{
+		if constexpr (is_same_v<T, string_view>)
+			return strings[slot].view();								// a view of the run's value (no copy)
+		else if constexpr (is_same_v<T, bool>)
+			return ints[slot] != 0;
+		else
+			return ints[slot];
+	}
+
+	void setResult(int value)
+	{
+		intResult = value;
+	}
+
+	void setResult(bool value)
+	{
+		intResult = value;
+	}
+
+	void setResult(string_view value)									// copied into the run's memory
+	{
+		strResult = StringValue(value);
+	}
+
+	void setResult(const string &value)
+	{
+		strResult = StringValue(string_view(value));
+	}
+
+	void setResult(StringValue value)
+	{
+		strResult = move(value);
+	}
+};
+
+
+//__________________________________________________NATIVE FUNCTION____________________________________________________
+// Function of the host program: the types of its result and parameters, and the call of it through NativeCall
+struct nativeFunction
+{
+	string name;
+	lexemeType result;
+	vector<lexemeType> params;
+	int ints;															// number of int / bool parameters
+	int strings;														// number of string parameters
+	function<void(NativeCall&)> call;
+};
+
+
+//__________________________________________________NATIVE FUNCTIONS___________________________________________________
+// Functions of the host program that model language programs call by name, like f(x, "text"). A function is an
+// ordinary C++ function or lambda: its parameters are int, bool or string_view, and its result is int, bool or a
+// string (string_view, string or StringValue). The types are taken from its signature, so the parser checks the
+// arguments of a call, which is then a single RPN_CALL_NATIVE instruction taking them off the executer's stacks as
+// they are. A string argument is a view valid during the call. A function may throw InterpreterError to stop the run.
+// The functions are registered before the programs that call them are compiled, and are not changed afterwards: a
+// compiled program keeps them, so they may be called by runs on any threads at once
+class NativeFunctions
+{
+	vector<nativeFunction> functions;
+	unordered_map<string, int> numbers;									// numbers of the functions by name
+
+	template <class T>
+	static constexpr lexemeType typeOf()
+	{
+		using U = decay_t<T>;
+		if constexpr (is_same_v<U, bool>)
+			return LEX_BOOL;
+		else if constexpr (is_same_v<U, int>)
+			return LEX_INT;
+		else if constexpr (is_same_v<U, string_view> || is_same_v<U, string> || is_same_v<U, StringValue>)
+			return LEX_STRING;
+		else
+			static_assert(is_same_v<U, int>, "native functions take and give int, bool and string values");
+	}
+
+	// Position of the parameter among those kept on the same stack
+	static constexpr int slot(const lexemeType types[], size_t param)
+	{
+		int count = 0;
+		for (size_t i = 0; i < param; i++)
+			count += (types[i] == LEX_STRING) == (types[param] == LEX_STRING);
+		return count;
+	}
+
+	// Signature of a function, a function pointer or a lambda
+	template <class F>
+	struct signature : signature<decltype(&F::operator())> {};
+
+	template <class R, class... P>
+	struct signature<R(*)(P...)>
+	{
+		using type = R(*)(P...);
+	};
+
+	template <class C, class R, class... P>
+	struct signature<R(C::*)(P...) const>
+	{
+		using type = R(*)(P...);
+	};
+
+	template <class C, class R, class... P>
+	struct signature<R(C::*)(P...)>
+	{
+		using type = R(*)(P...);
+	};
+
+	template <class F, class R, class... P, size_t... I>
+	static void invoke(F &f, NativeCall &call, index_sequence<I...>)
+	{
+		[[maybe_unused]] static constexpr lexemeType types[] = {typeOf<P>()..., LEX_NULL};
+		call.setResult(f(call.argument<decay_t<P>>(slot(types, I))...));
+	}
+
+	template <class F, class R, class... P>
+	void add(const string &name, F f, R(*)(P...))
+	{
+		static_assert(!is_void_v<R>, "native functions give a value");
+		vector<lexemeType> params = {typeOf<P>()...};
+		int strings = count(params.begin(), params.end(), LEX_STRING);
+		functions.push_back(nativeFunction {name, typeOf<R>(), params, (int) params.size() - strings, strings,
+			[f = move(f)](NativeCall &call) mutable
+			{
+				invoke<F, R, P...>(f, call, index_sequence_for<P...>());
+			}});
+	}
+
+public:
+	// Register the function under the name, which programs use as an identifier (InterpreterError if the name is not
+	// one, or if it is taken)
+	template <class F>
+	void add(const string &name, F f)
+	{
+		if (name.empty() || !isalpha(name[0]) || !all_of(name.begin(), name.end(), [](char c) { return isalnum(c); }))
+			throw InterpreterError("\"" + name + "\" cannot be the name of a native function");
+		if (!numbers.emplace(name, functions.size()).second)
+			throw InterpreterError("Native function \"" + name + "\" is registered twice");
+		add(name, move(f), (typename signature<decay_t<F>>::type) nullptr);
+	}
+
+	// Number of the function with the name (-1 if there is none)
+	int find(const string &name) const
+	{
+		auto it = numbers.find(name);
+		return it == numbers.end() ? -1 : it->second;
+	}
+
+	const nativeFunction& get(int number) const
+	{
+		return functions[number];
+	}
+
+	int size() const
+	{
+		return functions.size();
+	}
+};
@@ -1,1040 +1,1563 @@
-#include <iostream>
-#include <stack>
-#include "LexicalAnalyser.cpp"
-
-using namespace std;
-
-
-/*____________________________________SYNTAX STRUCTURE OF A MODEL LANGUAGE PROGRAM_____________________________________
- * Legend:
- *	1) (A | B) = (A OR B)
- *  2) (A; [ B | C | D ]) = (A; B) OR (A; C) OR (A; D)
- * 	3) (A <; B>) = (A) OR (A; B)
- *  4) ({ A; B }) = code block of operations A and B
- *
- * 
- * Program header:			HEADER   	-->  program { CODE_BLOCK }
- *
- * Descriptions:			DESCS		-->  DESC; DESCS | DESC; | eps
- * Description				DESC		--> [int | string | bool] VAR <, VAR>			
- * Variable					VAR	    	--> LEX_ID | LEX_ID = CONST														
- * Constant parameter		CONST   	--> INT | STR | BOOL
- *
- * Operations				CODE_BLOCK	--> <OP>
- * Operation				OP       	--> DESCS | OP_STMNT | { OPS } | if (STMNT) OP <else OP> | while (STMNT) OP | 
- * 										 	for ([STMNT]; [STMNT]; [STMNT]) OP | break; | goto LABEL; | read(ID); | write (STMNT <, STMNT>);
- * Statement operator		OP_STMNT 	--> STMNT | ID = STMNT;
- * Statement				STMNT    	--> ADD | ADD = STMNT | ADD [==|<|>|<=|>=|!=] ADD 
- * Additive state			ADD		 	--> MULTI | MULTI [+ | - | or] MULTI
- * Multiplicative state		MULTI	 	--> FIN | FIN [ * | / | and] FIN
- * Final state 				FIN		 	--> ID | LABEL: | ID++ | ID-- | ++ID | --ID | [+ | -] FIN | STR | BOOL | not FIN | STMNT
- */
-
-
-//___________________________________________REVERSE POLISH NOTATION PARSER____________________________________________
-class Parser
-{
-    Scanner scanner;                                                    // Lexical scanner
-	vector<Lexeme> RPNs;                                                // Reverse Polish Notation (RPN) table (vectorised)
-    
-    stack<lexemeType> lexStack;
-    Lexeme lex;                                                         // Current lexeme
-	lexemeType type;                                                    // Current lexeme's type
-	int val;                                                            // Current lexeme's value
-	
-	bool loopState;														// Indicator that the program iscurrently in loop state
-	int nestedLoopsCount;												// Number of nested loops (-1 : no loop state; 0 : no nested loops; >= 1 : >= 1 nested loops)
-	bool lvalue;
-	
-	struct breakStackItem
-	{
-		int nestedLoopNumber;
-		int position;
-	};
-	stack<breakStackItem> breakStack;						    		// Stack for break operators (Stack item consists of label's position in RPN and number of a nested loop containing the break operator)
-	
-	stack<int> plusStack;
-	stack<int> minusStack;
-	stack<int> lvalueUncertainStack;
-	int num;
-	
-	bool pp_id;
-	
-	// Syntax actions
-	void HEADER();															// Program's header
-
-	void DESCS();														// Descriptions
-	void DESC();														// Description		
-	void VAR();															// Variable													
-	void CONST();														// Constant parameter
-
-	void OPS();															// Operators
-	void OP();															// Operator
-	void OP_STMNT();													// Statement operator
-	void STMNT(int x=1);												// Statement
-	void ADD();															// Additive state
-	void MULTI();														// Multiplicative state
-	void FIN();															// Final state
-	
-	// Semantic actions
-	void setVar();
-	void identCheck(int value);
-	void identReadCheck();
-	void operationCheck();
-	void unaryOperationCheck();
-	void notCheck();
-	void assignEqualTypeCheck();
-	void conditionEqualTypeCheck();
-	void breakController(bool mode);
-	void breakCheck();
-	void gotoCheck();
-	
-	// Convertion to RPN
-	void unaryOperationToRPN();
-	
-	// Get the next lexeme
-	void getLexeme()
-	{
-		lex = scanner.getLexeme();          							// The scanner gets a lexeme
-		type = lex.getType();					                		// Get the lexeme's type
-		val = lex.getValue();					        		        // Get the lexeme's value
-	}
-	
-	// Syntax error processing
-	void syntaxError(int errNumber, string err)
-	{
-		try
-		{
-			throw err;
-		}
-		catch(string s)
-		{
-			cerr << "SYNTAX ERROR #" << errNumber << ": " << s << "\nLexeme: " << lex << endl;
-			exit(1);
-		}
-	}
-	
-	// Semantic error processing
-	void semanticError(string err)
-	{
-		try
-		{
-			throw err;
-		}
-		catch(string s)
-		{
-			cerr << "ERROR: " << s << endl;
-			exit(1);
-		}
-	}
-	
-	// Semantic warning processing
-	void semanticWarning(string err)
-	{
-		try
-		{
-			throw err;
-		}
-		catch(string s)
-		{
-			cerr << "WARNING: " << s << endl << endl;
-		}
-	}
-	
-public:
-	Parser(const string fileName): scanner(fileName)
-	{
-		loopState = 0;
-		nestedLoopsCount = -1;
-		lvalue = 1;
-		pp_id = 0;
-	}
-
-    vector<Lexeme> getRPNs()
-    {
-        return RPNs;
-    }
-	
-	void analyse();
-};
-
-
-template <class T1, class T2>
-
-// Extract item from stack
-void extract(T1& stack, T2& item)
-{
-	item = stack.top();
-	stack.pop();
-}
-
-
-void Parser::analyse()
-{
-	clearTables();
-	RPNs.clear();
-
-	getLexeme();
-	HEADER();
-	if (type != LEX_FIN)
-		syntaxError(													// Syntax error #1
-			1,
-			"No final state found...how is this even possible?"
-		);
-	cout << "No lexical, syntax or semantic issues. Your program is flawless." << '\n';
-}
-
-//.........................SYNTAX ANALYSIS
-// Analyse code starting from the program's header
-void Parser::HEADER()
-{
-	if (type == LEX_PROGRAM)								    		// if first lexeme is program's header:
-		getLexeme();													//   get next lexeme
-	else 																// else:
-		syntaxError(2, "Did you forget 'program'?");					// Syntax error #2
-	if (type == LEX_LEFT_BRACE)											// if next lexeme is left brace:
-		getLexeme();													//   get next lexeme
-	else																// else:
-		syntaxError(3, "Did you forget '{'?");							// Syntax error #3
-	
-	OPS();																// operators analysis
-	gotoCheck();
-}
-
-// Descriptions analysis
-void Parser::DESCS()
-{
-	DESC();
-	if (type != LEX_SEMICOLON)						    				// if lexeme following the description is not semicolon:
-		syntaxError(4, "Did you forget ';'?");							// Syntax error #4
-	getLexeme();
-}
-
-// Single description analysis
-void Parser::DESC()
-{ 
-	lexemeType identType = type;						    			// save the type of variable to be described further (to assing a value of the same type when required)
-	lexStack.push(identType);			    							// push this type to lexemes stack
-	getLexeme();
-	VAR();																// analyse the variable
-	while (type == LEX_COMMA)			    							// while next lexeme is "," (i.e. while variables of the same type are being declared)
-	{
-		lexStack.push(identType);		    							//   push said type to lexemes stack once again
-		getLexeme();
-		VAR();															//   analyse next variable of the same type
-	}
-}
-
-// Variable analysis
-void Parser::VAR()
-{
-	if (type == LEX_ID)										
-	{
-		setVar();														// assign this lexeme its type (recently saved in lexemes stack)
-		RPNs.push_back(Lexeme(RPN_ADDRESS, val));						// add the lexeme to the RPN table
-		getLexeme();
-		
-		if(type == LEX_ASSIGN)											// if the identifier above is being assigned a constant value
-		{
-            getLexeme();
-            CONST();													//   analyse the constant value
-            RPNs.push_back(LEX_ASSIGN);
-        }
-		else
-		{
-			RPNs.pop_back();
-		}
-		if (type == LEX_COMMA || type == LEX_SEMICOLON)		            // if the next lexeme is comma or semicolon:
-			lexStack.pop(); 											//		удаление из стека типа переменной и возврат из разбора отдельной переменной
-		else
-			syntaxError(5, "Unallowed deliminator. Only '=' available");// Syntax error #5
-	}
-	else																// if the lexeme is NOT an identifier:		
-	{
-		syntaxError(6, "No identifier found");							// Syntax error #6
-	}
-}
-
-// Constant value analysis
-void Parser::CONST()
-{
-	auto currentType = lexStack.top();
-	if (currentType == LEX_INT || currentType == LEX_STRING || currentType == LEX_BOOL)
-	{
-        STMNT(0);
-        assignEqualTypeCheck();
-    }
-	else
-	{
-		syntaxError(7, "No matching const type found");					// Syntax error #7
-	}
-}
-
-// Analysis of multiple operators
-void Parser::OPS()
-{
-	while (type != LEX_RIGHT_BRACE)
-	{
-		OP();
-		if (type == LEX_FIN)
-			syntaxError(8, "Did you forget '}'?");						// Syntax error #8
-	}
-	getLexeme();
-}
-
-// Analysis of a single operator
-void Parser::OP()
-{
-	int pos0;
-	int pos1;
-	int pos2;
-	int pos3;
-	int pos4;
-	
-	switch (type)
-	{
-		case LEX_INT: case LEX_BOOL: case LEX_STRING:					// Description of identifiers
-			DESCS();
-			break;
-			
-		case LEX_IF:													// if() operator
-			getLexeme();
-			if (type != LEX_LEFT_PAREN)
-				syntaxError(											// Syntax error #9
-					9,
-					"'if' expression: expected '(' after 'if'"
-				);
-			getLexeme();
-			STMNT();
-			conditionEqualTypeCheck();
-
-			pos2 = RPNs.size();
-			RPNs.push_back(Lexeme());
-			RPNs.push_back(Lexeme(RPN_FGO));
-			
-			if (type != LEX_RIGHT_PAREN)
-				syntaxError(											// Syntax error #10
-					10,
-					"'if' expression: did you forget ')' ?"
-				);
-			getLexeme();
-			OP();
-			RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
-			
-			if (type == LEX_ELSE)
-			{
-				pos3 = RPNs.size();
-				RPNs.push_back(Lexeme());
-				RPNs.push_back(Lexeme(RPN_GO));
-				RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
-                getLexeme();
-				OP();
-				RPNs[pos3] = Lexeme(RPN_LABEL, RPNs.size());
-			}
-			break;
-		
-		case LEX_WHILE:													// while() loop
-			pos0 = RPNs.size();
-			getLexeme();
-			if (type != LEX_LEFT_PAREN)
-				syntaxError(											// Syntax error #11
-					11,
-					"'while' expression: expected '(' after 'while'"
-				);
-			getLexeme();
-			STMNT();
-			conditionEqualTypeCheck();
-			pos1 = RPNs.size(); 
-			RPNs.push_back(Lexeme());
-			RPNs.push_back(Lexeme(RPN_FGO));
-			
-			if (type != LEX_RIGHT_PAREN)
-				syntaxError(											// Syntax error #12
-					12,
-					"'while' expression: did you forget ')' ?"
-				);
-			breakController(1);											// break operators processing in RPN table is also done via breakController (0 = off, 1 = on)
-			getLexeme();
-			OP();
-			
-			RPNs.push_back(Lexeme(RPN_LABEL, pos0));
-            RPNs.push_back(Lexeme(RPN_GO));
-            RPNs[pos1] = Lexeme(RPN_LABEL, RPNs.size());
-            
-            breakController(0);
-			break;
-		
-		case LEX_FOR:													// for(;;) loop
-			getLexeme();
-			if (type != LEX_LEFT_PAREN)
-				syntaxError(											// Syntax error #13
-					13,
-					"'for' expression: expected '(' after 'for'"
-				);
-			getLexeme();
-
-			// for(<analysing this part>; ...; ...)
-			if (type == LEX_SEMICOLON)
-				getLexeme();
-			else if (type == LEX_INT || type == LEX_BOOL || type == LEX_STRING)
-				DESCS();												// the first part of 'for' loop initialisation can be either a variable declaration (always assigning it a cretain value)
-			else
-				OP_STMNT();												// or a statement operator
-			pos3 = RPNs.size();
-			
-			// for(...; <analysing this part>; ...)
-			if (type == LEX_SEMICOLON)	
-			{
-				RPNs.push_back(Lexeme(LEX_TRUE, 1));
-				getLexeme();
-			} 
-			else
-			{
-				STMNT();
-				conditionEqualTypeCheck();
-				if (type != LEX_SEMICOLON)
-					syntaxError(										// Syntax error #14
-						14, 
-						"'for' expression: ';' between last two statements is missing"
-					);
-				getLexeme();
-			}
-			
-			pos1 = RPNs.size();
-			RPNs.push_back(Lexeme());
-			RPNs.push_back(Lexeme(RPN_FGO));
-			
-			pos2 = RPNs.size();
-			RPNs.push_back(Lexeme());
-			RPNs.push_back(Lexeme(RPN_GO));
-			pos4 = RPNs.size();
-			
-			//    for(...; ...; <analysing this part>)
-			if (type == LEX_RIGHT_PAREN)
-				getLexeme();
-			else
-			{
-				STMNT();
-			
-				RPNs.push_back(Lexeme(RPN_LABEL, pos3));
-				RPNs.push_back(Lexeme(RPN_GO));
-			
-				if (type != LEX_RIGHT_PAREN)
-					syntaxError(										// Syntax error #15
-						15, 
-						"'for' expression: did you forget ')' ?"
-					);
-				getLexeme();
-			}
-			RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
-			
-			breakController(1);
-			OP();
-			
-			RPNs.push_back(Lexeme(RPN_LABEL, pos4));
-			RPNs.push_back(Lexeme(RPN_GO));
-			RPNs[pos1] = Lexeme(RPN_LABEL, RPNs.size());
-			
-			breakController(0);
-			break;
-		
-		case LEX_BREAK:													// break operator
-			breakCheck();
-			getLexeme();
-			if (type != LEX_SEMICOLON)
-				syntaxError(16, "did you forget ';' ?");				// Syntax error #16
-			getLexeme();
-			break;
-		
-		case LEX_GOTO:													// goto operator
-            getLexeme();
-			if (type != LEX_ID)
-				syntaxError(											// Syntax error #17
-					17, 
-					"expected label after \"goto\" operator"
-				);
-			if (!identTable[val].isLabel())				        		// if the identifier is not declared as label:
-			{
-				if (!identTable[val].isDeclared())	    				//   if the identifier is not declared at all:
-				{
-					identTable[val].setAsLabel();							//      set it as a label (implying this label was not present before in the code)
-					identTable[val].setAddress(RPNs.size());
-					RPNs.push_back(Lexeme());
-					RPNs.push_back(Lexeme(RPN_GO));
-				}
-				else 													//   else: the identifier is already declared as a variable => error
-				{
-					syntaxError(										// Syntax error #18
-						18, 
-						"the identifier has already been declared"
-					);
-				}
-			}
-			else 														// else: the identifier has already been declared as label
-			{															//   i.e. this label was present in the code before
-				int value = identTable[val].getValue();
-				RPNs.push_back(Lexeme(RPN_LABEL, value));
-				RPNs.push_back(Lexeme(RPN_GO));
-			}
-			getLexeme();
-			if (type != LEX_SEMICOLON)
-				syntaxError(											// Syntax error #19
-					19, 
-					"\"goto\" operator: did you forget ';' ?"
-				);
-			getLexeme();
-			break;
-		
-		case LEX_READ:													// read() operator
-			getLexeme();
-			if (type != LEX_LEFT_PAREN)
-				syntaxError(											// Syntax error #20
-					20, 
-					"'read' expression: expected '(' after 'read'"
-				);
-			getLexeme();
-			if (type != LEX_ID)
-				syntaxError(											// Syntax error #21
-					21, 
-					"'read' expression: identifier not found"
-				);
-			identReadCheck();
-			RPNs.push_back(Lexeme(RPN_ADDRESS, val));
-			getLexeme();
-			
-			if (type != LEX_RIGHT_PAREN)
-			    syntaxError(											// Syntax error #22
-					22, 
-					"'read' expression: did you forget ')' ?"
-				);
-			getLexeme();
-			RPNs.push_back(Lexeme(LEX_READ));
-				
-			if (type != LEX_SEMICOLON)
-				syntaxError(23, "Did you forget ';' ?");				// Syntax error #23
-			getLexeme();
-			break;
-		
-		case LEX_WRITE:	case LEX_WRITELINE:								// write() and writeline() operators
-		{
-			lexemeType writeMode = type;
-			getLexeme();
-			if (type != LEX_LEFT_PAREN)
-				syntaxError(											// Syntax error #24
-					24, 
-					"'write' expression: expected '(' after 'write'"
-				);
-			getLexeme();
-			if (type == LEX_RIGHT_PAREN)
-				syntaxError(											// Syntax error #25
-					25,
-					"'write' expression: identifier not found"
-				);
-			STMNT(0);
-			while (type == LEX_COMMA)
-			{
-				getLexeme();
-				STMNT(0);
-			}
-
-			if (type != LEX_RIGHT_PAREN)
-				syntaxError(											// Syntax error #26
-					26,
-					"'write' expression: did you forget ')' ?"
-				);
-			getLexeme();
-			RPNs.push_back(Lexeme(writeMode));
-			if (type != LEX_SEMICOLON)
-				syntaxError(											// Syntax error #27
-					27,
-					"Did you forget ';' ?"
-				);
-			getLexeme();
-			break;
-		}
-		case LEX_LEFT_BRACE:											// Composite operator
-			getLexeme();
-			OPS();
-			break;
-		
-		default:														// Statement operator
-			OP_STMNT();
-			break;
-	}
-}
-
-// Statement operator analysis
-void Parser::OP_STMNT()
-{
-	pp_id = 0;
-	STMNT(1);
-	if (type == LEX_SEMICOLON || type == LEX_COLON)
-		getLexeme();
-	else
-		syntaxError(28, "Did you forget ';' ?");						// Syntax error #28
-}
-
-// Statement analysis
-void Parser::STMNT(int operand)
-{
-	lvalue = operand;
-	lexemeType assignedType = type;  									// save the type of lvalue lexeme (in case of assigning variable of a different type)
-	ADD();
-	
-	if (type == LEX_ASSIGN)												// if assignment takes place:
-	{
-		if (assignedType == LEX_ID && lvalue)							//   check that before assignment was lvalue statement identifier
-		{
-			pp_id = 1;
-			int lvalueUncertain;
-			extract(lvalueUncertainStack, lvalueUncertain);
-			RPNs[num] = Lexeme(RPN_ADDRESS, lvalueUncertain);
-			getLexeme();
-			STMNT();
-			assignEqualTypeCheck();
-			RPNs.push_back(LEX_ASSIGN);
-			unaryOperationToRPN();
-		}
-		else
-		{
-			syntaxError(												// Syntax error #29
-				29, 
-				"Lvalue required as a left operand of assignment"
-			);
-		}
-	}
-	else if (type >= LEX_EQ && type <= LEX_NOT_EQ)
-	{
-		lexemeType compareType = type;
-		
-		lvalue = 0;
-		lexStack.push(type); 
-		getLexeme();
-		ADD();
-		operationCheck();
-		RPNs.push_back(Lexeme(compareType));
-	}
-	
-	if (!lvalueUncertainStack.empty())
-	{
-		int lvalueUncertain;
-		extract(lvalueUncertainStack, lvalueUncertain);
-		RPNs[num] = lvalue ? Lexeme(RPN_ADDRESS, lvalueUncertain) : Lexeme(LEX_ID, lvalueUncertain);
-	}
-	
-	if (!pp_id)
-		unaryOperationToRPN();
-}
-
-void Parser::ADD()
-{
-	MULTI();
-	while (type == LEX_PLUS || type == LEX_MINUS || type == LEX_OR)
-	{
-		lexemeType additionType = type;
-		
-		lvalue = 0;
-		lexStack.push(type);
-		getLexeme();
-		MULTI();
-		operationCheck();
-		RPNs.push_back(Lexeme(additionType));
-	}
-}
-
-void Parser::MULTI()
-{
-	FIN();
-	while (type == LEX_TIMES || type == LEX_SLASH || type == LEX_PERCENT || type == LEX_AND)
-    {
-		lexemeType multiplicationType = type;
-		
-		lvalue = 0;
-		lexStack.push(type);
-		getLexeme();
-		FIN();
-        operationCheck();
-		RPNs.push_back(Lexeme(multiplicationType));
-	}
-}
-
-void Parser::FIN()
-{
-	switch (type)
-	{
-		case LEX_ID:
-		{
-			if (lvalue)
-			{
-				lvalueUncertainStack.push(val);
-				num = RPNs.size();
-				RPNs.push_back(Lexeme());
-			}
-			else
-			{
-				RPNs.push_back(Lexeme(LEX_ID, val));
-			}
-			int idValue = val;
-            getLexeme();
-			if (type == LEX_COLON)					    				// if ':' goes after the identifier:
-				if (!pp_id)
-				{														//   it means that identifier is a label
-					if (lvalue)
-						lvalueUncertainStack.pop();
-					RPNs.pop_back();
-					
-					if (identTable[idValue].isLabel())					//   if an identifier was declared as label before:					
-					{
-						int pos = identTable[idValue].getAddress();		//     pos - label's address in the code
-						if (identTable[idValue].getValue() != -1)		//	   if this label has already been assigned a value:
-						{												//       the label was placed twice within the code => error
-							syntaxError(								// Syntax error #30
-								30, 
-								"Label \"" + identTable[idValue].getName() + "\" is declared twice"
-							);
-						}
-						identTable[idValue].setValue(RPNs.size());		//     assign the location the label will lead to
-						identTable[idValue].setAssign();				//     confirm that label has been assigned a value
-						RPNs[pos] = Lexeme(RPN_LABEL, RPNs.size());
-					}
-					else if (!identTable[idValue].isDeclared())			//     if an identifier was not declared as label:		
-					{
-						identTable[idValue].setAsLabel();				//       declare the identifier as label
-						identTable[idValue].setValue(RPNs.size());		//       assign the location where label will lead to
-						identTable[idValue].setAssign();				//       confirm that label has been assigned a value
-					}
-					else
-					{	
-						syntaxError(									// Syntax error #31
-							31,
-							"Label \"" + identTable[idValue].getName() + "\" is already declared as an identifier and cannot be used"
-						);
-					}
-				}
-				else
-				{
-					syntaxError(										// Syntax error #32
-						32,
-						"Wrong usage of label \"" + identTable[idValue].getName() + "\""
-					);
-				}
-			else if (type == LEX_PLUS_PLUS || type == LEX_MINUS_MINUS)
-			{
-				if (!pp_id)
-					RPNs.pop_back();
-				lvalue = 0;
-				type == LEX_PLUS_PLUS ? plusStack.push(idValue) : minusStack.push(idValue);
-				getLexeme();
-			}
-			identCheck(idValue);
-			break;
-		}	
-		case LEX_NUM:		
-			lexStack.push(LEX_INT);							    		// the only available data type is 'int'. Put it in the lexemes stack
-			RPNs.push_back(lex);
-			getLexeme();
-			break;
-		
-		case LEX_PLUS:
-			lvalue = 0;
-			getLexeme();
-			FIN();
-			unaryOperationCheck();
-			break;
-		
-		case LEX_MINUS:
-			lvalue = 0;
-			getLexeme();
-			FIN();
-			unaryOperationCheck();
-			RPNs.push_back(Lexeme(LEX_UNARY_MINUS));
-			break;
-			
-		case LEX_PLUS_PLUS: case LEX_MINUS_MINUS:
-			lvalue = 0;
-			lexemeType unaryOpType;
-			unaryOpType = type == LEX_PLUS_PLUS ? LEX_PP_PRE : LEX_MM_PRE;// save unary operation's type to add it to RPN table
-			
-			getLexeme();
-			if (type != LEX_ID)
-				syntaxError(											// Syntax error #33
-					33, 
-					"Lvalue requied as an increment operand"
-				);
-			identCheck(val);
-			operationCheck();
-			if (!pp_id)
-			{
-				RPNs.push_back(Lexeme(RPN_ADDRESS, val));
-				RPNs.push_back(Lexeme(LEX_ID, val));
-				RPNs.push_back(Lexeme(LEX_NUM, 1));
-				unaryOpType == LEX_PP_PRE ?
-					RPNs.push_back(Lexeme(LEX_PLUS)) :
-					RPNs.push_back(Lexeme(LEX_MINUS));
-				RPNs.push_back(Lexeme(LEX_ASSIGN));
-			}
-			else
-			{
-				RPNs.push_back(Lexeme(RPN_ADDRESS, val));
-				RPNs.push_back(Lexeme(unaryOpType));
-			}
-			getLexeme();
-			break;
-		
-		case LEX_QUOTE:
-			getLexeme();
-			lexStack.push(LEX_STRING);
-            RPNs.push_back(lex);
-			if (type != LEX_STR_CONST)
-				syntaxError(34, "No string constant found");			// Syntax error #34
-			getLexeme();												// get the finishing quote (if it is missing lexical error will be triggered)
-			getLexeme();
-			break;
-		
-		case LEX_TRUE: case LEX_FALSE:
-			lexStack.push(LEX_BOOL);									// true and false are bool => put bool in the lexemes stack
-			type == LEX_TRUE ? 
-				RPNs.push_back(Lexeme(LEX_TRUE, 1)) :
-				RPNs.push_back(Lexeme(LEX_FALSE, 0));
-			getLexeme();
-			break;
-		
-		case LEX_NOT:
-			lvalue = 0;
-			getLexeme();
-			FIN();
-			notCheck();
-			RPNs.push_back(Lexeme(LEX_NOT));
-			break;
-		
-		case LEX_LEFT_PAREN:
-			getLexeme();
-			STMNT(0);
-			if (type != LEX_RIGHT_PAREN)
-				syntaxError(35, "Did you forget ')' ?");				// Syntax error #35
-			getLexeme();
-			break;
-		
-		default:
-			syntaxError(36, "No matching operand found");				// Syntax error #36
-			break;
-	}
-}
-
-
-//.........................SEMANTIC ANALYSIS
-// Set the variable's type and check its declaration status
-void Parser::setVar()
-{
-	if (identTable[val].isDeclared())							    	// if the variable has already been declared before:
-	{
-		semanticError(													//   semantic error
-			"Variable \"" + identTable[val].getName() + "\" is declared twice"
-		);
-	}
-	else 																// else:
-	{
-		identTable[val].setType(lexStack.top());		    			//   assign the variable its type (which is kept in the end of the lexemes stack)
-		identTable[val].setDeclare();				    				//   confirm the variable has been declared
-	}
-}
-
-// Check whether identifier was declared or not
-void Parser::identCheck(int value)
-{
-	if(identTable[value].isDeclared())									// if declared:
-		lexStack.push(identTable[value].getType());						//   add it to the lexemes stack
-	else																// else:
-		semanticError(													//   semantic error
-			"Variable \"" + identTable[value].getName() + "\" has not been declared"
-		);
-}
-
-// Check the identifier's declaration in read()
-void Parser::identReadCheck()
-{
-	if(!identTable[val].isDeclared())
-		semanticError(
-			"in 'read()' function: Variable \"" + identTable[val].getName() + "\" has not been declared"
-		);
-}
-
-// Single operation check
-void Parser::operationCheck()
-{
-	lexemeType opLeft;													// left operand 
-	lexemeType opRight;													// right operand
-	lexemeType oper;													// operator
-	
-	lexemeType opType;													// operation's type
-	lexemeType resType;													// operation result's type
-
-	extract(lexStack, opRight);
-	extract(lexStack, oper);
-	extract(lexStack, opLeft);
-	
-	if (opLeft == LEX_STRING && opLeft == opRight)
-	{
-		opType = LEX_STRING;
-		if(oper == LEX_PLUS)
-			resType = LEX_STRING;
-		else if (
-			oper == LEX_EQ ||
-			oper == LEX_NOT_EQ ||
-			oper == LEX_GREATER ||
-			oper == LEX_LESS
-		)
-			resType = LEX_BOOL;
-		else
-			semanticError("Unallowed operator for variables of type \"string\"");
-	}
-	else
-	{
-		if (oper >= LEX_EQ && oper <= LEX_NOT_EQ)
-		{
-			opType = LEX_INT;
-			resType = LEX_BOOL;
-		}
-		else if (oper >= LEX_PLUS && oper <= LEX_PERCENT)
-		{
-			opType = LEX_INT;
-			resType = LEX_INT;
-		}
-		else if (oper == LEX_OR || oper == LEX_AND)
-		{
-			opType = LEX_BOOL;
-			resType = LEX_BOOL;
-		}
-	}
-	if (
-		opLeft == opRight && opLeft == opType ||
-		opType == LEX_BOOL && opLeft != LEX_STRING && opRight != LEX_STRING
-	)
-		lexStack.push(resType);
-	else
-		semanticError("Variable types in the operation do not match");
-}
-
-void Parser::unaryOperationCheck()
-{
-	int opType = lexStack.top();										// operand's type is kept at the end of the lexemes stack
-	if(opType != LEX_INT)												// if operand's type is not integer:
-		semanticError("Wrong type for unary operation");				//   semantic error
-}
-
-// 'not' operator check
-void Parser::notCheck()
-{
-	lexemeType opType = lexStack.top();
-	if(opType != LEX_BOOL)
-		semanticError("Wrong type in 'not' statement");
-}
-
-// Check of equality of variable type and statement type before assignment
-void Parser::assignEqualTypeCheck()
-{
-	lexemeType typeRight;												// statement (or right variable) type 
-	extract(lexStack, typeRight);										// extract it from the lexemes stack
-	if (																// NOTE: it is allowed to assign integer values to bool variables
-		lexStack.top() != typeRight &&
-		(lexStack.top() != LEX_BOOL || typeRight != LEX_INT)
-	)
-		semanticError("The types do not match");
-}
-
-// Check of statement type in conditions of if() / while() / for(;;) / do-while()
-void Parser::conditionEqualTypeCheck()
-{
-	if(lexStack.top() == LEX_BOOL)										// must be bool
-		lexStack.pop();
-	else
-		semanticError("The expression is not boolean");
-}
-
-// Break controller
-void Parser::breakController(bool turnedOn)
-{
-	if(turnedOn)														// if turned on:
-	{
-        loopState = 1;													//   the code is in loop state
-        nestedLoopsCount++;												//   number of nested loops may also increase
-    }
-	else
-	{
-		if(!nestedLoopsCount)											// if a standard loop was finished and not a nested one:
-			loopState = 0;											    //   the code is out of loop state
-		
-		breakStackItem item;											// if a loop (standard or nested) has a break operator in it, then break stack keeps the nested
-		while(!breakStack.empty())										// loop number, from where break was called, and a position of its label in the RPN table
-		{																// thus, if break stack is not empty:
-			extract(breakStack, item);									//   extract the number of nested loop and label's postion in RPN table
-			if(item.nestedLoopNumber == nestedLoopsCount)
-			{
-				RPNs[item.position] = Lexeme(RPN_LABEL, RPNs.size());	//	 assign end of the loop as a transfer location for this label
-			}
-			else
-			{
-                breakStack.push(item);
-                break;
-            }
-		}
-		nestedLoopsCount--;
-	}
-}
-
-// Checking break
-void Parser::breakCheck()
-{
-	if(loopState)														// if the code is in loop state:
-	{
-		int pos = RPNs.size();
-		breakStackItem newItem {nestedLoopsCount, pos};
-		breakStack.push(newItem);										//   push break's position in RPN into stack
-		RPNs.push_back(Lexeme());										//   add empty lexeme (will be assigned transfer location later) to RPN table
-		RPNs.push_back(Lexeme(RPN_GO));								    //   add transfer lexeme to RPN table
-	}
-	else																// else:
-	{																	//    semantic error
-		semanticError("'break' can only be used in cycles");
-	}
-}
-
-// Checking goto operation
-void Parser::gotoCheck()
-{
-	vector<Identifier>::iterator it;
-	for(it = identTable.begin(); it != identTable.end(); ++it)
-	{
-		if(it->isLabel())
-		{
-			if(it->isAssigned() && it->getAddress() == -1)
-				semanticWarning("label \""+ it->getName() + "\" declared, but not used");
-			if(!it->isAssigned() && it->getAddress() != -1)
-				semanticError("label \""+ it->getName() + "\" used, but not declared");
-		}
-	}
-}
-
-// Converting unary operation to RPN
-void Parser::unaryOperationToRPN()
-{
-	int value;
-	while(!plusStack.empty())
-	{
-		extract(plusStack, value);
-	    RPNs.push_back(Lexeme(RPN_ADDRESS, value));
-		RPNs.push_back(Lexeme(LEX_ID, value));
-		RPNs.push_back(Lexeme(LEX_NUM, 1));
-		RPNs.push_back(Lexeme(LEX_PLUS));
-		RPNs.push_back(Lexeme(LEX_ASSIGN));
-	}
-	while(!minusStack.empty())
-	{
-		extract(minusStack, value);
-		RPNs.push_back(Lexeme(RPN_ADDRESS, value));
-		RPNs.push_back(Lexeme(LEX_ID, value));
-		RPNs.push_back(Lexeme(LEX_NUM, 1));
-		RPNs.push_back(Lexeme(LEX_MINUS));
-		RPNs.push_back(Lexeme(LEX_ASSIGN));
-	}
+#include <iostream>
+#include <sstream>
+#include <stack>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <algorithm>
+#include "NativeFunctions.cpp"
+
+using namespace std;
+
+
+/*____________________________________SYNTAX STRUCTURE OF A MODEL LANGUAGE PROGRAM_____________________________________
+ * Legend:
+ *	1) (A | B) = (A OR B)
+ *  2) (A; [ B | C | D ]) = (A; B) OR (A; C) OR (A; D)
+ * 	3) (A <; B>) = (A) OR (A; B)
+ *  4) ({ A; B }) = code block of operations A and B
+ *
+ * 
+ * Program header:			HEADER   	-->  program { CODE_BLOCK }
+ *
+ * Descriptions:			DESCS		-->  DESC; DESCS | DESC; | FUNC | eps
+ * Description				DESC		--> [int | string | bool] VAR <, VAR>			
+ * Variable					VAR	    	--> LEX_ID | LEX_ID = CONST														
+ * Constant parameter		CONST   	--> INT | STR | BOOL
+ * Function definition		FUNC		--> [int | string | bool] LEX_ID (<PARAM <, PARAM>>) { OPS }
+ * Parameter				PARAM		--> [int | string | bool] LEX_ID
+ *
+ * Operations				CODE_BLOCK	--> <OP>
+ * Operation				OP       	--> DESCS | OP_STMNT | { OPS } | if (STMNT) OP <else OP> | while (STMNT) OP | 
+ * 										 	for ([STMNT]; [STMNT]; [STMNT]) OP | break; | goto LABEL; | read(ID); | write (STMNT <, STMNT>); |
+ * 										 	return STMNT;
+ * Statement operator		OP_STMNT 	--> STMNT | ID = STMNT;
+ * Statement				STMNT    	--> ADD | ADD = STMNT | ADD [==|<|>|<=|>=|!=] ADD 
+ * Additive state			ADD		 	--> MULTI | MULTI [+ | - | or] MULTI
+ * Multiplicative state		MULTI	 	--> FIN | FIN [ * | / | and] FIN
+ * Final state 				FIN		 	--> ID | LABEL: | ID++ | ID-- | ++ID | --ID | [+ | -] FIN | STR | BOOL | not FIN | STMNT |
+ * 										 	CALL(<STMNT <, STMNT>>)
+ * Function call			CALL		--> LEX_ID of a function defined before (FUNC), or of one registered by the host program
+ * 										 	(see NativeFunctions.cpp)
+ *
+ * A function is defined where descriptions are, outside loops and functions. Its parameters and the variables it
+ * declares are local to it, and hide the program's variables of the same names; 'return' is used in its body only.
+ *
+ * STMNT, ADD and MULTI are parsed together by an operator-precedence parser with an explicit stack (see precedenceLevel):
+ * MULTI operations bind tighter than ADD operations, a statement holds at most one comparison, and assignment is
+ * right-associative.
+ */
+
+
+//__________________________________________________PROGRAM STREAMS____________________________________________________
+// Where a run takes its input and puts its output (a batch run gives every program streams of its own)
+struct programStreams
+{
+	istream *in = &cin;													// values for read() (in STREAM_INPUT mode)
+	ostream *out = &cout;												// program's output and the interpreter's messages
+	ostream *err = &cerr;												// warnings and diagnostics
+};
+
+
+//__________________________________________________PROGRAM FUNCTION___________________________________________________
+// Function defined by the program. Its parameters and the variables it declares are local: every call has a frame of
+// its own for them, where they are kept in the slots given to them by the parser (the parameters first)
+struct programFunction
+{
+	int ident;															// identifier of its name
+	lexemeType result;													// type of its result
+	vector<lexemeType> locals;											// types of the local variables by their slots
+	vector<int> names;													// identifiers of the local variables by their slots
+	int params;															// number of parameters
+	int ints;															// number of int / bool parameters
+	int strings;														// number of string parameters
+	int entry;															// position of its first instruction in the RPN table
+};
+
+
+//___________________________________________REVERSE POLISH NOTATION PARSER____________________________________________
+class Parser
+{
+    Scanner scanner;                                                    // Lexical scanner
+	bool pipelined;														// indicator that the scanner runs on a thread of its own
+	int lexingThreads;													// threads scanning parts of the program at once
+	unique_ptr<LexemeSource> source;									// where the lexemes come from, unless from the scanner itself
+	programStreams streams;
+	const NativeFunctions *natives;										// functions of the host program (none - nullptr)
+	bool timing;														// indicator that the time spent in the scanner is measured
+	chrono::steady_clock::duration lexTime;								// time spent in the scanner (waiting for it when pipelined)
+	pmr::vector<Lexeme> RPNs;                                           // Reverse Polish Notation (RPN) table (vectorised, kept in the run's arena)
+    
+    arenaStack<lexemeType> lexStack;
+    Lexeme lex;                                                         // Current lexeme
+	lexemeType type;                                                    // Current lexeme's type
+	int val;                                                            // Current lexeme's value
+	
+	bool loopState;														// Indicator that the program iscurrently in loop state
+	int nestedLoopsCount;												// Number of nested loops (-1 : no loop state; 0 : no nested loops; >= 1 : >= 1 nested loops)
+	bool lvalue;
+	
+	struct breakStackItem
+	{
+		int nestedLoopNumber;
+		int position;
+	};
+	arenaStack<breakStackItem> breakStack;						    		// Stack for break operators (Stack item consists of label's position in RPN and number of a nested loop containing the break operator)
+	
+	arenaStack<int> plusStack;
+	arenaStack<int> minusStack;
+	arenaStack<int> lvalueUncertainStack;
+	int num;
+	
+	enum precedenceLevel												// precedence levels of binary operations (the higher binds tighter)
+	{
+		NO_OPERATION,
+		ASSIGNMENT,														// =
+		RELATIONAL,														// ==, !=, <, >, <=, >=
+		ADDITIVE,														// +, -, or
+		MULTIPLICATIVE													// *, /, %, and
+	};
+	
+	enum exprState														// states of the statement parser's frames
+	{
+		EXPR_STATEMENT,													// statement: waiting for its left-hand side
+		EXPR_ASSIGN,													// statement: waiting for the right-hand side of assignment
+		EXPR_COMPARE,													// statement: waiting for the right operand of comparison
+		EXPR_BINARY,													// binary operations of a given level and higher
+		EXPR_UNARY,														// unary operation ('+', '-', 'not')
+		EXPR_PAREN														// parenthesised statement
+	};
+	
+	struct exprFrame
+	{
+		exprState state;
+		lexemeType op;													// pending operation (or the type of the statement's first lexeme)
+		int level;														// lowest precedence level accepted by EXPR_BINARY
+	};
+	arenaStack<exprFrame> exprStack;											// explicit (heap-allocated) stack of the statement parser
+	
+	bool pp_id;
+
+	vector<programFunction> functions;									// functions defined by the program
+	unordered_map<int, int> functionNumbers;							// numbers of the functions by identifier
+	int currentFunction;												// function being analysed (-1 : none)
+	vector<int> localSlots;												// slots of its local variables by identifier (-1 : not local)
+	unordered_map<int, int> labelFunctions;								// function each label is placed or used in (-1 : none)
+
+public:
+	// Top-level statement of the program: its text goes from the end of the previous statement to the end of its last
+	// lexeme. A statement is analysed according to the pp_id it gets from the one before
+	struct statementOutline
+	{
+		size_t begin;
+		size_t end;
+		int rpnBegin;													// position of its first instruction in the RPN table
+		vector<int> declared;											// identifiers it declares
+		bool carriedIn;													// pp_id when it begins
+		bool carriedOut;												// pp_id when it ends
+		bool settled;													// indicator that no postfix operation is left for the next one
+	};
+
+private:
+	bool outlining;														// indicator that the top-level statements are outlined
+	vector<statementOutline> outline;
+	size_t previousEnd;													// position in the text right after the lexeme before the current one
+	
+	// Syntax actions
+	void HEADER();															// Program's header
+
+	void DESCS(bool definitions=false);									// Descriptions
+	bool DESC(bool definitions);										// Description		
+	int VAR(bool definitions);											// Variable													
+	void CONST();														// Constant parameter
+	void FUNCTION(int ident, lexemeType result);						// Function definition
+
+	void OPS(bool topLevel=false);										// Operators
+	void TOP_OP();														// Top-level operator (outlined)
+	void OP();															// Operator
+	void OP_STMNT();													// Statement operator
+	void STMNT(int x=1);												// Statement
+	bool FIN();															// Final state (operand)
+	void CALL(int idValue);												// Function call
+	
+	// Operator-precedence parsing of statements
+	void startStatement(int operand);
+	void finishStatement();
+	static int precedence(lexemeType op);
+	
+	// Semantic actions
+	void setVar(int ident);
+	void declareLocal(int ident, lexemeType varType);
+	void typesCheck(size_t count);
+	void identCheck(int value);
+	void identReadCheck();
+	void operationCheck();
+	void unaryOperationCheck();
+	void notCheck();
+	void assignEqualTypeCheck();
+	void conditionEqualTypeCheck();
+	void breakController(bool mode);
+	void breakCheck();
+	void gotoCheck();
+	void labelCheck(int ident);
+	
+	// Convertion to RPN
+	void unaryOperationToRPN();
+
+	void reset();
+
+	// Slot of the identifier in the frame of the function being analysed (-1 if it is not local to it)
+	int localSlot(int ident)
+	{
+		return ident < (int) localSlots.size() ? localSlots[ident] : -1;
+	}
+
+	// Instructions taking the address and the value of the identifier (a local one is found in the frame of the call)
+	Lexeme addressOf(int ident)
+	{
+		int slot = localSlot(ident);
+		return slot < 0 ? Lexeme(RPN_ADDRESS, ident) : Lexeme(RPN_LOCAL_ADDRESS, slot);
+	}
+
+	Lexeme valueOf(int ident)
+	{
+		int slot = localSlot(ident);
+		return slot < 0 ? Lexeme(LEX_ID, ident) : Lexeme(RPN_LOCAL, slot);
+	}
+	
+	// Get the next lexeme
+	void getLexeme()
+	{
+		if (outlining)
+			previousEnd = scanner.offset();
+		if (timing)
+		{
+			auto start = chrono::steady_clock::now();
+			lex = source ? source->next() : scanner.getLexeme();
+			lexTime += chrono::steady_clock::now() - start;
+		}
+		else
+			lex = source ? source->next() : scanner.getLexeme();		// The scanner gets a lexeme
+		type = lex.getType();					                		// Get the lexeme's type
+		val = lex.getValue();					        		        // Get the lexeme's value
+	}
+	
+	// Syntax error processing
+	void syntaxError(int errNumber, string err)
+	{
+		ostringstream message;
+		message << "SYNTAX ERROR #" << errNumber << ": " << err << "\nLexeme: " << lex;
+		throw InterpreterError(message.str());
+	}
+	
+	// Semantic error processing
+	void semanticError(string err)
+	{
+		throw InterpreterError("ERROR: " + err);
+	}
+	
+	// Semantic warning processing
+	void semanticWarning(string err)
+	{
+		*streams.err << "WARNING: " << err << endl << endl;
+	}
+	
+public:
+	Parser(ProgramSource source, Arena &arena, programStreams s=programStreams()):
+		scanner(move(source), &arena),
+		pipelined(false),
+		lexingThreads(0),
+		streams(s),
+		natives(nullptr),
+		timing(false),
+		lexTime(0),
+		RPNs(&arena),
+		lexStack(&arena),
+		breakStack(&arena),
+		plusStack(&arena),
+		minusStack(&arena),
+		lvalueUncertainStack(&arena),
+		exprStack(&arena),
+		outlining(false),
+		previousEnd(0)
+	{
+		loopState = 0;
+		nestedLoopsCount = -1;
+		lvalue = 1;
+		pp_id = 0;
+		currentFunction = -1;
+	}
+
+    pmr::vector<Lexeme>& getRPNs()
+    {
+        return RPNs;
+    }
+
+	// Measure the time spent in the scanner
+	void setTiming(bool on)
+	{
+		timing = on;
+	}
+
+	chrono::steady_clock::duration getLexTime()
+	{
+		return lexTime;
+	}
+
+	// Let the program call the host's functions (must be set before the analysis; they must outlive it)
+	void setNatives(const NativeFunctions *functions)
+	{
+		natives = functions;
+	}
+
+	// Run the scanner on a thread of its own, ahead of the parser (must be set before the analysis)
+	void setPipelining(bool on)
+	{
+		pipelined = on;
+	}
+
+	// Scan parts of the program on the given number of threads at once before parsing it (0 - one scanner as usual;
+	// must be set before the analysis)
+	void setLexingThreads(int threads)
+	{
+		lexingThreads = threads;
+	}
+
+	// Outline the top-level statements of the program (they are analysed by the scanner itself: pipelining and lexing
+	// threads are not used)
+	void setOutlining(bool on)
+	{
+		outlining = on;
+	}
+
+	const vector<statementOutline>& getOutline()
+	{
+		return outline;
+	}
+
+	// Functions defined by the analysed program, by the numbers its calls give them
+	const vector<programFunction>& getFunctions()
+	{
+		return functions;
+	}
+	
+	void analyse();
+	void analyseStatements(string_view text, bool carried, const function<bool(size_t, bool)> &done);
+};
+
+
+template <class T1, class T2>
+
+// Extract item from stack
+void extract(T1& stack, T2& item)
+{
+	item = move(stack.top());
+	stack.pop();
+}
+
+template <class T>
+
+// Remove every item from stack
+void clearStack(T& stack)
+{
+	while (!stack.empty())
+		stack.pop();
+}
+
+// Forget the state of the previous analysis (which may have been stopped by an error)
+void Parser::reset()
+{
+	clearStack(lexStack);
+	clearStack(breakStack);
+	clearStack(plusStack);
+	clearStack(minusStack);
+	clearStack(lvalueUncertainStack);
+	clearStack(exprStack);
+	loopState = 0;
+	nestedLoopsCount = -1;
+	lvalue = 1;
+	pp_id = 0;
+	functions.clear();
+	functionNumbers.clear();
+	currentFunction = -1;
+	localSlots.clear();
+	labelFunctions.clear();
+}
+
+
+void Parser::analyse()
+{
+	clearTables();
+	reset();
+	RPNs.clear();
+	outline.clear();
+	if (outlining)														// the positions of the lexemes are taken from the scanner
+		source.reset();
+	else if (lexingThreads)
+		source = make_unique<ChunkedLexer>(scanner, lexingThreads);
+	else if (pipelined)
+		source = make_unique<TokenPipeline>(scanner);
+
+	getLexeme();
+	HEADER();
+	if (type != LEX_FIN)
+		syntaxError(													// Syntax error #1
+			1,
+			"No final state found...how is this even possible?"
+		);
+	*streams.out << "No lexical, syntax or semantic issues. Your program is flawless." << '\n';
+}
+
+// Analyse top-level statements from the given text, which begins where one of them does (right after the previous one,
+// which has left the given pp_id), until done() accepts the end of one and the pp_id it leaves, or the closing brace of
+// the program comes. The statements are outlined, and the RPN table is theirs. The positions in the text and in the RPN
+// are counted from the beginning of the statements
+void Parser::analyseStatements(string_view text, bool carried, const function<bool(size_t, bool)> &done)
+{
+	reset();
+	pp_id = carried;
+	RPNs.clear();
+	outline.clear();
+	source.reset();
+	scanner = Scanner(text, false, false, scanner.getMemory());
+	outlining = true;
+	previousEnd = 0;
+
+	getLexeme();
+	while (type != LEX_RIGHT_BRACE)
+	{
+		TOP_OP();
+		if (done(outline.back().end, pp_id))
+			return;
+		if (type == LEX_FIN)
+			syntaxError(8, "Did you forget '}'?");						// Syntax error #8
+	}
+}
+
+//.........................SYNTAX ANALYSIS
+// Analyse code starting from the program's header
+void Parser::HEADER()
+{
+	if (type == LEX_PROGRAM)								    		// if first lexeme is program's header:
+		getLexeme();													//   get next lexeme
+	else 																// else:
+		syntaxError(2, "Did you forget 'program'?");					// Syntax error #2
+	if (type == LEX_LEFT_BRACE)											// if next lexeme is left brace:
+		getLexeme();													//   get next lexeme
+	else																// else:
+		syntaxError(3, "Did you forget '{'?");							// Syntax error #3
+	
+	OPS(true);															// operators analysis
+	gotoCheck();
+}
+
+// Descriptions analysis (a function may be defined in their place where definitions are allowed)
+void Parser::DESCS(bool definitions)
+{
+	if (DESC(definitions))												// a function definition ends with its body
+		return;
+	if (type != LEX_SEMICOLON)						    				// if lexeme following the description is not semicolon:
+		syntaxError(4, "Did you forget ';'?");							// Syntax error #4
+	getLexeme();
+}
+
+// Single description analysis. Returns true if it has turned out to be a function definition
+bool Parser::DESC(bool definitions)
+{ 
+	lexemeType identType = type;						    			// save the type of variable to be described further (to assing a value of the same type when required)
+	lexStack.push(identType);			    							// push this type to lexemes stack
+	getLexeme();
+	int function = VAR(definitions);									// analyse the variable
+	if (function >= 0)													// it is the name of a function, with its parameters next
+	{
+		lexStack.pop();
+		FUNCTION(function, identType);
+		return true;
+	}
+	while (type == LEX_COMMA)			    							// while next lexeme is "," (i.e. while variables of the same type are being declared)
+	{
+		lexStack.push(identType);		    							//   push said type to lexemes stack once again
+		getLexeme();
+		VAR(false);														//   analyse next variable of the same type
+	}
+	return false;
+}
+
+// Variable analysis. Returns the identifier if '(' follows it where functions may be defined (it is the name of one
+// then), and -1 otherwise
+int Parser::VAR(bool definitions)
+{
+	if (type == LEX_ID)										
+	{
+		int ident = val;
+		getLexeme();
+		if (definitions && type == LEX_LEFT_PAREN)
+			return ident;
+		setVar(ident);													// assign this lexeme its type (recently saved in lexemes stack)
+		RPNs.push_back(addressOf(ident));								// add the lexeme to the RPN table
+		
+		if(type == LEX_ASSIGN)											// if the identifier above is being assigned a constant value
+		{
+            getLexeme();
+            CONST();													//   analyse the constant value
+            RPNs.push_back(LEX_ASSIGN);
+        }
+		else
+		{
+			RPNs.pop_back();
+		}
+		if (type == LEX_COMMA || type == LEX_SEMICOLON)		            // if the next lexeme is comma or semicolon:
+			lexStack.pop(); 											//		удаление из стека типа переменной и возврат из разбора отдельной переменной
+		else
+			syntaxError(5, "Unallowed deliminator. Only '=' available");// Syntax error #5
+	}
+	else																// if the lexeme is NOT an identifier:		
+	{
+		syntaxError(6, "No identifier found");							// Syntax error #6
+	}
+	return -1;
+}
+
+// Function definition analysis. The function's code is jumped over where it stands, and is entered by its calls only.
+// It is known from its name on, so it may call itself. Falling off the end of its body returns the default value of
+// its type (0, false or an empty string)
+void Parser::FUNCTION(int ident, lexemeType result)
+{
+	string name = identTable[ident].getName();
+	if (currentFunction >= 0 || loopState)
+		semanticError("Function \"" + name + "\" is defined inside a function or a loop");
+	if (identTable[ident].isDeclared())
+		semanticError("\"" + name + "\" is declared twice");
+	identTable[ident].setDeclare();										// the name is taken (a function has no type of a variable)
+	functionNumbers[ident] = functions.size();
+	currentFunction = functions.size();
+	functions.push_back(programFunction {ident, result, {}, {}, 0, 0, 0, 0});
+
+	unaryOperationToRPN();												// what the statements before have left is done before the jump
+	int skip = RPNs.size();
+	RPNs.push_back(Lexeme());
+	RPNs.push_back(Lexeme(RPN_GO));
+	functions[currentFunction].entry = RPNs.size();
+
+	getLexeme();
+	if (type != LEX_RIGHT_PAREN)
+		while (true)
+		{
+			if (type != LEX_INT && type != LEX_BOOL && type != LEX_STRING)
+				syntaxError(38, "Expected the type of a parameter");	// Syntax error #38
+			lexStack.push(type);
+			getLexeme();
+			if (type != LEX_ID)
+				syntaxError(39, "Expected the name of a parameter");	// Syntax error #39
+			setVar(val);
+			lexStack.pop();
+			getLexeme();
+			if (type != LEX_COMMA)
+				break;
+			getLexeme();
+		}
+	if (type != LEX_RIGHT_PAREN)
+		syntaxError(40, "Did you forget ')' ?");						// Syntax error #40
+	programFunction &function = functions[currentFunction];
+	function.params = function.locals.size();
+	function.strings = count(function.locals.begin(), function.locals.end(), LEX_STRING);
+	function.ints = function.params - function.strings;
+
+	getLexeme();
+	if (type != LEX_LEFT_BRACE)
+		syntaxError(41, "Did you forget '{'?");							// Syntax error #41
+	getLexeme();
+	OPS();
+	unaryOperationToRPN();
+	RPNs.push_back(Lexeme(RPN_RETURN, 0));
+	RPNs[skip] = Lexeme(RPN_LABEL, RPNs.size());
+
+	for (int local : functions[currentFunction].names)					// the names are the program's again
+		localSlots[local] = -1;
+	currentFunction = -1;
+}
+
+// Constant value analysis
+void Parser::CONST()
+{
+	auto currentType = lexStack.top();
+	if (currentType == LEX_INT || currentType == LEX_STRING || currentType == LEX_BOOL)
+	{
+        STMNT(0);
+        assignEqualTypeCheck();
+    }
+	else
+	{
+		syntaxError(7, "No matching const type found");					// Syntax error #7
+	}
+}
+
+// Analysis of multiple operators
+void Parser::OPS(bool topLevel)
+{
+	while (type != LEX_RIGHT_BRACE)
+	{
+		if (topLevel && outlining)
+			TOP_OP();
+		else
+			OP();
+		if (type == LEX_FIN)
+			syntaxError(8, "Did you forget '}'?");						// Syntax error #8
+	}
+	getLexeme();
+}
+
+// Analysis of a top-level operator, which is added to the outline
+void Parser::TOP_OP()
+{
+	outline.push_back(statementOutline {previousEnd, 0, (int) RPNs.size(), {}, pp_id, false, false});
+	OP();
+	outline.back().end = previousEnd;
+	outline.back().carriedOut = pp_id;
+	outline.back().settled = plusStack.empty() && minusStack.empty() && lvalueUncertainStack.empty();
+}
+
+// Analysis of a single operator
+void Parser::OP()
+{
+	int pos0;
+	int pos1;
+	int pos2;
+	int pos3;
+	int pos4;
+	
+	switch (type)
+	{
+		case LEX_INT: case LEX_BOOL: case LEX_STRING:					// Description of identifiers (or definition of a function)
+			DESCS(true);
+			break;
+			
+		case LEX_IF:													// if() operator
+			getLexeme();
+			if (type != LEX_LEFT_PAREN)
+				syntaxError(											// Syntax error #9
+					9,
+					"'if' expression: expected '(' after 'if'"
+				);
+			getLexeme();
+			STMNT();
+			conditionEqualTypeCheck();
+
+			pos2 = RPNs.size();
+			RPNs.push_back(Lexeme());
+			RPNs.push_back(Lexeme(RPN_FGO));
+			
+			if (type != LEX_RIGHT_PAREN)
+				syntaxError(											// Syntax error #10
+					10,
+					"'if' expression: did you forget ')' ?"
+				);
+			getLexeme();
+			OP();
+			RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
+			
+			if (type == LEX_ELSE)
+			{
+				pos3 = RPNs.size();
+				RPNs.push_back(Lexeme());
+				RPNs.push_back(Lexeme(RPN_GO));
+				RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
+                getLexeme();
+				OP();
+				RPNs[pos3] = Lexeme(RPN_LABEL, RPNs.size());
+			}
+			break;
+		
+		case LEX_WHILE:													// while() loop
+			pos0 = RPNs.size();
+			getLexeme();
+			if (type != LEX_LEFT_PAREN)
+				syntaxError(											// Syntax error #11
+					11,
+					"'while' expression: expected '(' after 'while'"
+				);
+			getLexeme();
+			STMNT();
+			conditionEqualTypeCheck();
+			pos1 = RPNs.size(); 
+			RPNs.push_back(Lexeme());
+			RPNs.push_back(Lexeme(RPN_FGO));
+			
+			if (type != LEX_RIGHT_PAREN)
+				syntaxError(											// Syntax error #12
+					12,
+					"'while' expression: did you forget ')' ?"
+				);
+			breakController(1);											// break operators processing in RPN table is also done via breakController (0 = off, 1 = on)
+			getLexeme();
+			OP();
+			
+			RPNs.push_back(Lexeme(RPN_LABEL, pos0));
+            RPNs.push_back(Lexeme(RPN_GO));
+            RPNs[pos1] = Lexeme(RPN_LABEL, RPNs.size());
+            
+            breakController(0);
+			break;
+		
+		case LEX_FOR:													// for(;;) loop
+			getLexeme();
+			if (type != LEX_LEFT_PAREN)
+				syntaxError(											// Syntax error #13
+					13,
+					"'for' expression: expected '(' after 'for'"
+				);
+			getLexeme();
+
+			// for(<analysing this part>; ...; ...)
+			if (type == LEX_SEMICOLON)
+				getLexeme();
+			else if (type == LEX_INT || type == LEX_BOOL || type == LEX_STRING)
+				DESCS();												// the first part of 'for' loop initialisation can be either a variable declaration (always assigning it a cretain value)
+			else
+				OP_STMNT();												// or a statement operator
+			pos3 = RPNs.size();
+			
+			// for(...; <analysing this part>; ...)
+			if (type == LEX_SEMICOLON)	
+			{
+				RPNs.push_back(Lexeme(LEX_TRUE, 1));
+				getLexeme();
+			} 
+			else
+			{
+				STMNT();
+				conditionEqualTypeCheck();
+				if (type != LEX_SEMICOLON)
+					syntaxError(										// Syntax error #14
+						14, 
+						"'for' expression: ';' between last two statements is missing"
+					);
+				getLexeme();
+			}
+			
+			pos1 = RPNs.size();
+			RPNs.push_back(Lexeme());
+			RPNs.push_back(Lexeme(RPN_FGO));
+			
+			pos2 = RPNs.size();
+			RPNs.push_back(Lexeme());
+			RPNs.push_back(Lexeme(RPN_GO));
+			pos4 = RPNs.size();
+			
+			//    for(...; ...; <analysing this part>)
+			if (type == LEX_RIGHT_PAREN)
+				getLexeme();
+			else
+			{
+				STMNT();
+			
+				RPNs.push_back(Lexeme(RPN_LABEL, pos3));
+				RPNs.push_back(Lexeme(RPN_GO));
+			
+				if (type != LEX_RIGHT_PAREN)
+					syntaxError(										// Syntax error #15
+						15, 
+						"'for' expression: did you forget ')' ?"
+					);
+				getLexeme();
+			}
+			RPNs[pos2] = Lexeme(RPN_LABEL, RPNs.size());
+			
+			breakController(1);
+			OP();
+			
+			RPNs.push_back(Lexeme(RPN_LABEL, pos4));
+			RPNs.push_back(Lexeme(RPN_GO));
+			RPNs[pos1] = Lexeme(RPN_LABEL, RPNs.size());
+			
+			breakController(0);
+			break;
+		
+		case LEX_BREAK:													// break operator
+			breakCheck();
+			getLexeme();
+			if (type != LEX_SEMICOLON)
+				syntaxError(16, "did you forget ';' ?");				// Syntax error #16
+			getLexeme();
+			break;
+		
+		case LEX_GOTO:													// goto operator
+            getLexeme();
+			if (type != LEX_ID)
+				syntaxError(											// Syntax error #17
+					17, 
+					"expected label after \"goto\" operator"
+				);
+			labelCheck(val);
+			if (!identTable[val].isLabel())				        		// if the identifier is not declared as label:
+			{
+				if (!identTable[val].isDeclared())	    				//   if the identifier is not declared at all:
+				{
+					identTable[val].setAsLabel();							//      set it as a label (implying this label was not present before in the code)
+					identTable[val].setAddress(RPNs.size());
+					RPNs.push_back(Lexeme());
+					RPNs.push_back(Lexeme(RPN_GO));
+				}
+				else 													//   else: the identifier is already declared as a variable => error
+				{
+					syntaxError(										// Syntax error #18
+						18, 
+						"the identifier has already been declared"
+					);
+				}
+			}
+			else 														// else: the identifier has already been declared as label
+			{															//   i.e. this label was present in the code before
+				int value = identTable[val].getValue();
+				RPNs.push_back(Lexeme(RPN_LABEL, value));
+				RPNs.push_back(Lexeme(RPN_GO));
+			}
+			getLexeme();
+			if (type != LEX_SEMICOLON)
+				syntaxError(											// Syntax error #19
+					19, 
+					"\"goto\" operator: did you forget ';' ?"
+				);
+			getLexeme();
+			break;
+		
+		case LEX_READ:													// read() operator
+			getLexeme();
+			if (type != LEX_LEFT_PAREN)
+				syntaxError(											// Syntax error #20
+					20, 
+					"'read' expression: expected '(' after 'read'"
+				);
+			getLexeme();
+			if (type != LEX_ID)
+				syntaxError(											// Syntax error #21
+					21, 
+					"'read' expression: identifier not found"
+				);
+			identReadCheck();
+			RPNs.push_back(addressOf(val));
+			getLexeme();
+			
+			if (type != LEX_RIGHT_PAREN)
+			    syntaxError(											// Syntax error #22
+					22, 
+					"'read' expression: did you forget ')' ?"
+				);
+			getLexeme();
+			RPNs.push_back(Lexeme(LEX_READ));
+				
+			if (type != LEX_SEMICOLON)
+				syntaxError(23, "Did you forget ';' ?");				// Syntax error #23
+			getLexeme();
+			break;
+		
+		case LEX_WRITE:	case LEX_WRITELINE:								// write() and writeline() operators
+		{
+			lexemeType writeMode = type;
+			getLexeme();
+			if (type != LEX_LEFT_PAREN)
+				syntaxError(											// Syntax error #24
+					24, 
+					"'write' expression: expected '(' after 'write'"
+				);
+			getLexeme();
+			if (type == LEX_RIGHT_PAREN)
+				syntaxError(											// Syntax error #25
+					25,
+					"'write' expression: identifier not found"
+				);
+			STMNT(0);
+			while (type == LEX_COMMA)
+			{
+				getLexeme();
+				STMNT(0);
+			}
+
+			if (type != LEX_RIGHT_PAREN)
+				syntaxError(											// Syntax error #26
+					26,
+					"'write' expression: did you forget ')' ?"
+				);
+			getLexeme();
+			RPNs.push_back(Lexeme(writeMode));
+			if (type != LEX_SEMICOLON)
+				syntaxError(											// Syntax error #27
+					27,
+					"Did you forget ';' ?"
+				);
+			getLexeme();
+			break;
+		}
+		case LEX_RETURN:												// return operator
+			if (currentFunction < 0)
+				semanticError("'return' can only be used in functions");
+			pp_id = 0;
+			getLexeme();
+			lexStack.push(functions[currentFunction].result);			// the value is checked like an assigned one
+			STMNT(0);
+			assignEqualTypeCheck();
+			lexStack.pop();
+			RPNs.push_back(Lexeme(RPN_RETURN, 1));
+			if (type != LEX_SEMICOLON)
+				syntaxError(42, "Did you forget ';' ?");				// Syntax error #42
+			getLexeme();
+			break;
+
+		case LEX_LEFT_BRACE:											// Composite operator
+			getLexeme();
+			OPS();
+			break;
+		
+		default:														// Statement operator
+			OP_STMNT();
+			break;
+	}
+}
+
+// Statement operator analysis
+void Parser::OP_STMNT()
+{
+	pp_id = 0;
+	STMNT(1);
+	if (type == LEX_SEMICOLON || type == LEX_COLON)
+		getLexeme();
+	else
+		syntaxError(28, "Did you forget ';' ?");						// Syntax error #28
+}
+
+// Statement analysis
+// Statements are parsed by an operator-precedence parser: instead of recursion through STMNT -> ADD -> MULTI -> FIN
+// (four native calls per nesting level) the pending parts of the statement are kept in the explicit expression stack
+void Parser::STMNT(int operand)
+{
+	int base = exprStack.size();										// the statement is complete when the stack shrinks back to this size
+	bool operandReady;													// indicator that the last operand (FIN) is complete
+
+	startStatement(operand);
+	operandReady = false;
+	while ((int) exprStack.size() > base)
+	{
+		if (!operandReady)												// an operand is expected:
+		{
+			operandReady = FIN();										//   parse it (prefix operations only push their frames)
+			continue;
+		}
+
+		exprFrame &frame = exprStack.top();								// the operand is complete: pass it to the pending frame
+		switch (frame.state)
+		{
+			case EXPR_BINARY:											// binary operations of the frame's level or higher
+			{
+				if (frame.op != LEX_NULL)								//   the right operand of a pending operation is ready
+				{
+					operationCheck();
+					RPNs.push_back(Lexeme(frame.op));
+					frame.op = LEX_NULL;
+				}
+				int level = precedence(type);
+				if (level >= frame.level)								//   the next operation binds tightly enough: take its right operand
+				{
+					frame.op = type;
+					lvalue = 0;
+					lexStack.push(type);
+					getLexeme();
+					exprStack.push(exprFrame {EXPR_BINARY, LEX_NULL, level + 1});
+					operandReady = false;
+				}
+				else
+					exprStack.pop();
+				break;
+			}
+			case EXPR_STATEMENT:										// the left-hand side of the statement is ready
+				if (type == LEX_ASSIGN)									//   if assignment takes place:
+				{
+					if (frame.op == LEX_ID && lvalue)					//   check that before assignment was lvalue statement identifier
+					{
+						pp_id = 1;
+						int lvalueUncertain;
+						extract(lvalueUncertainStack, lvalueUncertain);
+						RPNs[num] = addressOf(lvalueUncertain);
+						getLexeme();
+						frame.state = EXPR_ASSIGN;
+						startStatement(1);								//   the right-hand side is a statement as well
+						operandReady = false;
+					}
+					else
+					{
+						syntaxError(									// Syntax error #29
+							29, 
+							"Lvalue required as a left operand of assignment"
+						);
+					}
+				}
+				else if (precedence(type) == RELATIONAL)				//   if comparison takes place:
+				{
+					frame.state = EXPR_COMPARE;
+					frame.op = type;
+					lvalue = 0;
+					lexStack.push(type); 
+					getLexeme();
+					exprStack.push(exprFrame {EXPR_BINARY, LEX_NULL, ADDITIVE});
+					operandReady = false;
+				}
+				else
+					finishStatement();
+				break;
+
+			case EXPR_ASSIGN:											// the right-hand side of assignment is ready
+				assignEqualTypeCheck();
+				RPNs.push_back(LEX_ASSIGN);
+				unaryOperationToRPN();
+				finishStatement();
+				break;
+
+			case EXPR_COMPARE:											// the right operand of comparison is ready
+				operationCheck();
+				RPNs.push_back(Lexeme(frame.op));
+				finishStatement();
+				break;
+
+			case EXPR_UNARY:											// the operand of a unary operation is ready
+				if (frame.op == LEX_NOT)
+				{
+					notCheck();
+					RPNs.push_back(Lexeme(LEX_NOT));
+				}
+				else
+				{
+					unaryOperationCheck();
+					if (frame.op == LEX_MINUS)
+						RPNs.push_back(Lexeme(LEX_UNARY_MINUS));
+				}
+				exprStack.pop();
+				break;
+
+			case EXPR_PAREN:											// the parenthesised statement is ready
+				if (type != LEX_RIGHT_PAREN)
+					syntaxError(35, "Did you forget ')' ?");			// Syntax error #35
+				getLexeme();
+				exprStack.pop();
+				break;
+		}
+	}
+}
+
+// Start a statement: its left-hand side is parsed first
+void Parser::startStatement(int operand)
+{
+	lvalue = operand;
+	exprStack.push(exprFrame {EXPR_STATEMENT, type, NO_OPERATION});	// save the type of lvalue lexeme (in case of assigning variable of a different type)
+	exprStack.push(exprFrame {EXPR_BINARY, LEX_NULL, ADDITIVE});
+}
+
+// Finish a statement: resolve the uncertain lvalue and the postfix operations
+void Parser::finishStatement()
+{
+	if (!lvalueUncertainStack.empty())
+	{
+		int lvalueUncertain;
+		extract(lvalueUncertainStack, lvalueUncertain);
+		if (num < (int) RPNs.size())									// the placeholder is gone if the identifier was incremented
+			RPNs[num] = lvalue ? addressOf(lvalueUncertain) : valueOf(lvalueUncertain);
+	}
+	
+	if (!pp_id)
+		unaryOperationToRPN();
+	exprStack.pop();
+}
+
+// Precedence level of a binary operation (NO_OPERATION if the lexeme is not one)
+int Parser::precedence(lexemeType op)
+{
+	switch (op)
+	{
+		case LEX_TIMES: case LEX_SLASH: case LEX_PERCENT: case LEX_AND:
+			return MULTIPLICATIVE;
+		
+		case LEX_PLUS: case LEX_MINUS: case LEX_OR:
+			return ADDITIVE;
+		
+		case LEX_EQ: case LEX_GREATER: case LEX_LESS: case LEX_GREATER_EQ: case LEX_LESS_EQ: case LEX_NOT_EQ:
+			return RELATIONAL;
+		
+		case LEX_ASSIGN:
+			return ASSIGNMENT;
+		
+		default:
+			return NO_OPERATION;
+	}
+}
+
+// Operand analysis. Returns false if only a prefix operation was parsed and its operand is still expected
+bool Parser::FIN()
+{
+	switch (type)
+	{
+		case LEX_ID:
+		{
+			if (lvalue)
+			{
+				lvalueUncertainStack.push(val);
+				num = RPNs.size();
+				RPNs.push_back(Lexeme());
+			}
+			else
+			{
+				RPNs.push_back(valueOf(val));
+			}
+			int idValue = val;
+            getLexeme();
+			if (type == LEX_COLON)					    				// if ':' goes after the identifier:
+				if (!pp_id)
+				{														//   it means that identifier is a label
+					labelCheck(idValue);
+					if (lvalue)
+						lvalueUncertainStack.pop();
+					RPNs.pop_back();
+					
+					if (identTable[idValue].isLabel())					//   if an identifier was declared as label before:					
+					{
+						int pos = identTable[idValue].getAddress();		//     pos - label's address in the code
+						if (identTable[idValue].getValue() != -1)		//	   if this label has already been assigned a value:
+						{												//       the label was placed twice within the code => error
+							syntaxError(								// Syntax error #30
+								30, 
+								"Label \"" + identTable[idValue].getName() + "\" is declared twice"
+							);
+						}
+						identTable[idValue].setValue(RPNs.size());		//     assign the location the label will lead to
+						identTable[idValue].setAssign();				//     confirm that label has been assigned a value
+						RPNs[pos] = Lexeme(RPN_LABEL, RPNs.size());
+					}
+					else if (!identTable[idValue].isDeclared())			//     if an identifier was not declared as label:		
+					{
+						identTable[idValue].setAsLabel();				//       declare the identifier as label
+						identTable[idValue].setValue(RPNs.size());		//       assign the location where label will lead to
+						identTable[idValue].setAssign();				//       confirm that label has been assigned a value
+					}
+					else
+					{	
+						syntaxError(									// Syntax error #31
+							31,
+							"Label \"" + identTable[idValue].getName() + "\" is already declared as an identifier and cannot be used"
+						);
+					}
+				}
+				else
+				{
+					syntaxError(										// Syntax error #32
+						32,
+						"Wrong usage of label \"" + identTable[idValue].getName() + "\""
+					);
+				}
+			else if (type == LEX_LEFT_PAREN)							// if '(' goes after the identifier, it is a call
+			{
+				if (lvalue)
+					lvalueUncertainStack.pop();
+				RPNs.pop_back();
+				CALL(idValue);
+				break;
+			}
+			else if (type == LEX_PLUS_PLUS || type == LEX_MINUS_MINUS)
+			{
+				if (!pp_id)
+					RPNs.pop_back();
+				lvalue = 0;
+				type == LEX_PLUS_PLUS ? plusStack.push(idValue) : minusStack.push(idValue);
+				getLexeme();
+			}
+			identCheck(idValue);
+			break;
+		}	
+		case LEX_NUM:		
+			lexStack.push(LEX_INT);							    		// the only available data type is 'int'. Put it in the lexemes stack
+			RPNs.push_back(lex);
+			getLexeme();
+			break;
+		
+		case LEX_PLUS: case LEX_MINUS: case LEX_NOT:					// unary operation: its operand goes next
+			lvalue = 0;
+			exprStack.push(exprFrame {EXPR_UNARY, type, NO_OPERATION});
+			getLexeme();
+			return false;
+			
+		case LEX_PLUS_PLUS: case LEX_MINUS_MINUS:
+			lvalue = 0;
+			lexemeType unaryOpType;
+			unaryOpType = type == LEX_PLUS_PLUS ? LEX_PP_PRE : LEX_MM_PRE;// save unary operation's type to add it to RPN table
+			
+			getLexeme();
+			if (type != LEX_ID)
+				syntaxError(											// Syntax error #33
+					33, 
+					"Lvalue requied as an increment operand"
+				);
+			identCheck(val);
+			operationCheck();
+			if (!pp_id)
+			{
+				RPNs.push_back(addressOf(val));
+				RPNs.push_back(valueOf(val));
+				RPNs.push_back(Lexeme(LEX_NUM, 1));
+				unaryOpType == LEX_PP_PRE ?
+					RPNs.push_back(Lexeme(LEX_PLUS)) :
+					RPNs.push_back(Lexeme(LEX_MINUS));
+				RPNs.push_back(Lexeme(LEX_ASSIGN));
+			}
+			else
+			{
+				RPNs.push_back(addressOf(val));
+				RPNs.push_back(Lexeme(unaryOpType));
+			}
+			getLexeme();
+			break;
+		
+		case LEX_QUOTE:
+			getLexeme();
+			lexStack.push(LEX_STRING);
+            RPNs.push_back(lex);
+			if (type != LEX_STR_CONST)
+				syntaxError(34, "No string constant found");			// Syntax error #34
+			getLexeme();												// get the finishing quote (if it is missing lexical error will be triggered)
+			getLexeme();
+			break;
+		
+		case LEX_TRUE: case LEX_FALSE:
+			lexStack.push(LEX_BOOL);									// true and false are bool => put bool in the lexemes stack
+			type == LEX_TRUE ? 
+				RPNs.push_back(Lexeme(LEX_TRUE, 1)) :
+				RPNs.push_back(Lexeme(LEX_FALSE, 0));
+			getLexeme();
+			break;
+		
+		case LEX_LEFT_PAREN:											// parenthesised statement
+			getLexeme();
+			exprStack.push(exprFrame {EXPR_PAREN, LEX_NULL, NO_OPERATION});
+			startStatement(0);
+			return false;
+		
+		default:
+			syntaxError(36, "No matching operand found");				// Syntax error #36
+			break;
+	}
+	return true;
+}
+
+// Function call analysis: every argument is checked against the type of its parameter the way an initial value is
+// checked against the type of a variable, and the call takes the place of an operand of the function's result type.
+// A function of the program is called with its entry label over the arguments, a native one by its number
+void Parser::CALL(int idValue)
+{
+	string name = identTable[idValue].getName();
+	auto defined = functionNumbers.find(idValue);
+	int number = natives ? natives->find(name) : -1;
+	if (localSlot(idValue) >= 0 ||										// a variable or a label is not called
+		(defined == functionNumbers.end() && (number < 0 || identTable[idValue].isDeclared())))
+		semanticError("\"" + name + "\" is not a function");
+	const lexemeType *params;
+	size_t count;
+	lexemeType result;
+	if (defined != functionNumbers.end())
+	{
+		const programFunction &function = functions[defined->second];
+		params = function.locals.data();
+		count = function.params;
+		result = function.result;
+	}
+	else
+	{
+		const nativeFunction &function = natives->get(number);
+		params = function.params.data();
+		count = function.params.size();
+		result = function.result;
+	}
+
+	lvalue = 0;
+	getLexeme();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i > 0 && type == LEX_COMMA)
+			getLexeme();
+		else if (i > 0 || type == LEX_RIGHT_PAREN)
+			semanticError("Too few arguments in the call of \"" + name + "\"");
+		lexStack.push(params[i]);
+		STMNT(0);
+		assignEqualTypeCheck();
+		lexStack.pop();
+	}
+	if (type == LEX_COMMA || (count == 0 && type != LEX_RIGHT_PAREN))
+		semanticError("Too many arguments in the call of \"" + name + "\"");
+	if (type != LEX_RIGHT_PAREN)
+		syntaxError(37, "Did you forget ')' ?");						// Syntax error #37
+	if (defined != functionNumbers.end())
+	{
+		RPNs.push_back(Lexeme(RPN_LABEL, functions[defined->second].entry));
+		RPNs.push_back(Lexeme(RPN_CALL, defined->second));
+	}
+	else
+		RPNs.push_back(Lexeme(RPN_CALL_NATIVE, number));
+	lexStack.push(result);
+	getLexeme();
+}
+
+
+//.........................SEMANTIC ANALYSIS
+// Set the variable's type and check its declaration status
+void Parser::setVar(int ident)
+{
+	if (currentFunction >= 0)											// a variable of a function is local to it
+		declareLocal(ident, lexStack.top());
+	else if (identTable[ident].isDeclared())							// if the variable has already been declared before:
+	{
+		semanticError(													//   semantic error
+			"Variable \"" + identTable[ident].getName() + "\" is declared twice"
+		);
+	}
+	else 																// else:
+	{
+		identTable[ident].setType(lexStack.top());		    			//   assign the variable its type (which is kept in the end of the lexemes stack)
+		identTable[ident].setDeclare();				    				//   confirm the variable has been declared
+		if (outlining)
+			outline.back().declared.push_back(ident);					//   the statement the declaration belongs to
+	}
+}
+
+// Give the local variable the next slot in the frame of the function being analysed
+void Parser::declareLocal(int ident, lexemeType varType)
+{
+	if (localSlot(ident) >= 0)
+		semanticError("Variable \"" + identTable[ident].getName() + "\" is declared twice");
+	programFunction &function = functions[currentFunction];
+	if (ident >= (int) localSlots.size())
+		localSlots.resize(ident + 1, -1);
+	localSlots[ident] = function.locals.size();
+	function.locals.push_back(varType);
+	function.names.push_back(ident);
+}
+
+// Check whether identifier was declared or not
+void Parser::identCheck(int value)
+{
+	if (localSlot(value) >= 0)											// a local variable hides the program's one
+		lexStack.push(functions[currentFunction].locals[localSlot(value)]);
+	else if (functionNumbers.count(value))
+		semanticError("Function \"" + identTable[value].getName() + "\" is used as a variable");
+	else if(identTable[value].isDeclared())								// if declared:
+		lexStack.push(identTable[value].getType());						//   add it to the lexemes stack
+	else																// else:
+		semanticError(													//   semantic error
+			"Variable \"" + identTable[value].getName() + "\" has not been declared"
+		);
+}
+
+// Check the identifier's declaration in read()
+void Parser::identReadCheck()
+{
+	if (localSlot(val) < 0 && (!identTable[val].isDeclared() || functionNumbers.count(val)))
+		semanticError(
+			"in 'read()' function: Variable \"" + identTable[val].getName() + "\" has not been declared"
+		);
+}
+
+// Single operation check
+// Check that the lexemes stack holds the types an operation needs (some statements the parser accepts, such as an
+// assignment of a prefix increment, leave it short)
+void Parser::typesCheck(size_t count)
+{
+	if (lexStack.size() < count)
+		semanticError("Malformed expression");
+}
+
+void Parser::operationCheck()
+{
+	lexemeType opLeft;													// left operand 
+	lexemeType opRight;													// right operand
+	lexemeType oper;													// operator
+	
+	lexemeType opType;													// operation's type
+	lexemeType resType;													// operation result's type
+
+	typesCheck(3);
+	extract(lexStack, opRight);
+	extract(lexStack, oper);
+	extract(lexStack, opLeft);
+	
+	if (opLeft == LEX_STRING && opLeft == opRight)
+	{
+		opType = LEX_STRING;
+		if(oper == LEX_PLUS)
+			resType = LEX_STRING;
+		else if (
+			oper == LEX_EQ ||
+			oper == LEX_NOT_EQ ||
+			oper == LEX_GREATER ||
+			oper == LEX_LESS
+		)
+			resType = LEX_BOOL;
+		else
+			semanticError("Unallowed operator for variables of type \"string\"");
+	}
+	else
+	{
+		if (oper >= LEX_EQ && oper <= LEX_NOT_EQ)
+		{
+			opType = LEX_INT;
+			resType = LEX_BOOL;
+		}
+		else if (oper >= LEX_PLUS && oper <= LEX_PERCENT)
+		{
+			opType = LEX_INT;
+			resType = LEX_INT;
+		}
+		else if (oper == LEX_OR || oper == LEX_AND)
+		{
+			opType = LEX_BOOL;
+			resType = LEX_BOOL;
+		}
+	}
+	if (
+		opLeft == opRight && opLeft == opType ||
+		opType == LEX_BOOL && opLeft != LEX_STRING && opRight != LEX_STRING
+	)
+		lexStack.push(resType);
+	else
+		semanticError("Variable types in the operation do not match");
+}
+
+void Parser::unaryOperationCheck()
+{
+	typesCheck(1);
+	int opType = lexStack.top();										// operand's type is kept at the end of the lexemes stack
+	if(opType != LEX_INT)												// if operand's type is not integer:
+		semanticError("Wrong type for unary operation");				//   semantic error
+}
+
+// 'not' operator check
+void Parser::notCheck()
+{
+	typesCheck(1);
+	lexemeType opType = lexStack.top();
+	if(opType != LEX_BOOL)
+		semanticError("Wrong type in 'not' statement");
+}
+
+// Check of equality of variable type and statement type before assignment
+void Parser::assignEqualTypeCheck()
+{
+	lexemeType typeRight;												// statement (or right variable) type 
+	typesCheck(2);
+	extract(lexStack, typeRight);										// extract it from the lexemes stack
+	if (																// NOTE: it is allowed to assign integer values to bool variables
+		lexStack.top() != typeRight &&
+		(lexStack.top() != LEX_BOOL || typeRight != LEX_INT)
+	)
+		semanticError("The types do not match");
+}
+
+// Check of statement type in conditions of if() / while() / for(;;) / do-while()
+void Parser::conditionEqualTypeCheck()
+{
+	typesCheck(1);
+	if(lexStack.top() == LEX_BOOL)										// must be bool
+		lexStack.pop();
+	else
+		semanticError("The expression is not boolean");
+}
+
+// Break controller
+void Parser::breakController(bool turnedOn)
+{
+	if(turnedOn)														// if turned on:
+	{
+        loopState = 1;													//   the code is in loop state
+        nestedLoopsCount++;												//   number of nested loops may also increase
+    }
+	else
+	{
+		if(!nestedLoopsCount)											// if a standard loop was finished and not a nested one:
+			loopState = 0;											    //   the code is out of loop state
+		
+		breakStackItem item;											// if a loop (standard or nested) has a break operator in it, then break stack keeps the nested
+		while(!breakStack.empty())										// loop number, from where break was called, and a position of its label in the RPN table
+		{																// thus, if break stack is not empty:
+			extract(breakStack, item);									//   extract the number of nested loop and label's postion in RPN table
+			if(item.nestedLoopNumber == nestedLoopsCount)
+			{
+				RPNs[item.position] = Lexeme(RPN_LABEL, RPNs.size());	//	 assign end of the loop as a transfer location for this label
+			}
+			else
+			{
+                breakStack.push(item);
+                break;
+            }
+		}
+		nestedLoopsCount--;
+	}
+}
+
+// Checking break
+void Parser::breakCheck()
+{
+	if(loopState)														// if the code is in loop state:
+	{
+		int pos = RPNs.size();
+		breakStackItem newItem {nestedLoopsCount, pos};
+		breakStack.push(newItem);										//   push break's position in RPN into stack
+		RPNs.push_back(Lexeme());										//   add empty lexeme (will be assigned transfer location later) to RPN table
+		RPNs.push_back(Lexeme(RPN_GO));								    //   add transfer lexeme to RPN table
+	}
+	else																// else:
+	{																	//    semantic error
+		semanticError("'break' can only be used in cycles");
+	}
+}
+
+// Checking goto operation
+void Parser::gotoCheck()
+{
+	vector<Identifier>::iterator it;
+	for(it = identTable.begin(); it != identTable.end(); ++it)
+	{
+		if(it->isLabel())
+		{
+			if(it->isAssigned() && it->getAddress() == -1)
+				semanticWarning("label \""+ it->getName() + "\" declared, but not used");
+			if(!it->isAssigned() && it->getAddress() != -1)
+				semanticError("label \""+ it->getName() + "\" used, but not declared");
+		}
+	}
+}
+
+// Check that the label is placed and used in one function (or outside functions)
+void Parser::labelCheck(int ident)
+{
+	auto placed = labelFunctions.emplace(ident, currentFunction);
+	if (!placed.second && placed.first->second != currentFunction)
+		semanticError("Label \"" + identTable[ident].getName() + "\" is used outside the function it is placed in");
+}
+
+// Converting unary operation to RPN
+void Parser::unaryOperationToRPN()
+{
+	int value;
+	while(!plusStack.empty())
+	{
+		extract(plusStack, value);
+	    RPNs.push_back(addressOf(value));
+		RPNs.push_back(valueOf(value));
+		RPNs.push_back(Lexeme(LEX_NUM, 1));
+		RPNs.push_back(Lexeme(LEX_PLUS));
+		RPNs.push_back(Lexeme(LEX_ASSIGN));
+	}
+	while(!minusStack.empty())
+	{
+		extract(minusStack, value);
+		RPNs.push_back(addressOf(value));
+		RPNs.push_back(valueOf(value));
+		RPNs.push_back(Lexeme(LEX_NUM, 1));
+		RPNs.push_back(Lexeme(LEX_MINUS));
+		RPNs.push_back(Lexeme(LEX_ASSIGN));
+	}
 }
\ No newline at end of file
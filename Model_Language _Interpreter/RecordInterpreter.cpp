@@ -0,0 +1,204 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include "Interpreter.cpp"
+#include "ThreadPool.cpp"
+
+using namespace std;
+
+
+//_____________________________________________________RECORD CHUNK____________________________________________________
+// Consecutive input lines run by one task. Each line is a record: the program is run once for it, and its read()
+// takes the fields of the record
+struct recordChunk
+{
+	long first;															// number of the first record (from 1)
+	vector<string> records;
+	string output;														// what the runs have written, in the order of the records
+	string errors;														// warnings and errors of the runs
+	int failed;															// records whose run has not ended with EXEC_OK
+};
+
+// Run the program for every record of the chunk. Fields may be separated with the delimiter as well as with blanks
+void runChunk(const CompiledProgram &program, const executionOptions &options, recordChunk &chunk, char delimiter)
+{
+	static thread_local ExecutionContext context;						// memory is reused by the runs of a worker
+	context.setOptions(options);
+
+	ostringstream output;
+	ostringstream errors;
+	programStreams streams;
+	streams.out = &output;
+	streams.err = &errors;
+
+	chunk.failed = 0;
+	for (size_t i = 0; i < chunk.records.size(); i++)
+	{
+		string &record = chunk.records[i];
+		if (delimiter)
+			replace(record.begin(), record.end(), delimiter, ' ');
+		istringstream fields(record);
+		streams.in = &fields;
+
+		executionStatus status;
+		try
+		{
+			status = context.run(program, streams);					// every run has a frame of variables of its own
+		}
+		catch (InterpreterError &error)
+		{
+			errors << error.what() << endl;
+			status = EXEC_ERROR;
+		}
+		if (status != EXEC_OK)
+		{
+			errors << "RECORD " << chunk.first + i << " FAILED: status " << status << endl;
+			chunk.failed++;
+		}
+	}
+	chunk.output = output.str();
+	chunk.errors = errors.str();
+}
+
+
+//____________________________________________________REORDER BUFFER___________________________________________________
+// Chunks are finished by the workers in any order; they are taken out of the buffer in the order of the input
+class ReorderBuffer
+{
+	mutex lock;
+	condition_variable ready;
+	map<long, shared_ptr<recordChunk>> finished;						// finished chunks by their sequence numbers
+	long next;															// sequence number of the chunk to be taken next
+
+public:
+	ReorderBuffer(): next(0) {}
+
+	void put(long sequence, shared_ptr<recordChunk> chunk)
+	{
+		lock_guard<mutex> guard(lock);
+		finished[sequence] = move(chunk);
+		if (sequence == next)
+			ready.notify_one();
+	}
+
+	// Wait for the next chunk of the input
+	shared_ptr<recordChunk> takeNext()
+	{
+		unique_lock<mutex> guard(lock);
+		ready.wait(guard, [this] { return !finished.empty() && finished.begin()->first == next; });
+		shared_ptr<recordChunk> chunk = move(finished.begin()->second);
+		finished.erase(finished.begin());
+		next++;
+		return chunk;
+	}
+};
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: RecordInterpreter [--threads N] [--chunk N] [--delimiter C] [--stats] [--fuel N] [--max-string-bytes N]
+//               [--time-limit MS] program < records
+int main(int argc, char *argv[])
+{
+	string fileName;
+	executionOptions options = executionOptions();
+	int threads = 0;
+	size_t chunkSize = 64;
+	char delimiter = 0;
+	bool stats = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--threads" && i + 1 < argc)							// number of workers (the machine's threads by default)
+			threads = atoi(argv[++i]);
+		else if (arg == "--chunk" && i + 1 < argc)						// records run by one task
+			chunkSize = max(1, atoi(argv[++i]));
+		else if (arg == "--delimiter" && i + 1 < argc)					// separator of the fields besides blanks
+			delimiter = argv[++i][0];
+		else if (arg == "--stats")										// report the throughput
+			stats = true;
+		else if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+			fileName = arg;
+	}
+	if (fileName.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--threads N] [--chunk N] [--delimiter C] [--stats] [--fuel N] "
+			 << "[--max-string-bytes N] [--time-limit MS] program < records\n";
+		return 1;
+	}
+	options.quiet = true;												// the output of the runs is the output of the records
+
+	shared_ptr<const CompiledProgram> program;							// the program is analysed only once
+	try
+	{
+		programStreams streams;
+		streams.out = &cerr;
+		Interpreter interpreter(ProgramSource::fromFile(fileName), STREAM_INPUT, nullptr, streams);
+		interpreter.compile();
+		program = interpreter.share();
+	}
+	catch (InterpreterError &error)
+	{
+		cerr << error.what() << endl;
+		return 1;
+	}
+
+	ThreadPool pool(threads);
+	ReorderBuffer buffer;
+	long window = 4L * pool.size();										// chunks in flight: keeps the workers busy and the memory bounded
+	long submitted = 0;
+	long emitted = 0;
+	long records = 0;
+	long failed = 0;
+
+	auto emitNext = [&]
+	{
+		shared_ptr<recordChunk> chunk = buffer.takeNext();
+		cout << chunk->output;
+		cerr << chunk->errors;
+		failed += chunk->failed;
+		emitted++;
+	};
+
+	auto start = chrono::steady_clock::now();
+	pool.start();
+	string line;
+	while (cin)
+	{
+		auto chunk = make_shared<recordChunk>();
+		chunk->first = records + 1;
+		while (chunk->records.size() < chunkSize && getline(cin, line))
+			chunk->records.push_back(line);
+		if (chunk->records.empty())
+			break;
+		records += chunk->records.size();
+
+		if (submitted - emitted == window)
+			emitNext();
+		long sequence = submitted++;
+		pool.submit([&program, &options, &buffer, chunk, sequence, delimiter]
+		{
+			runChunk(*program, options, *chunk, delimiter);
+			chunk->records.clear();
+			buffer.put(sequence, chunk);
+		});
+	}
+	while (emitted < submitted)
+		emitNext();
+	pool.finish();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	if (stats)
+		cerr << fixed << setprecision(3) << records << " records (" << failed << " failed) on " << pool.size()
+			 << " threads in " << seconds << " s: " << records / seconds << " records/s\n";
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <streambuf>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include "Executer.cpp"
+
+using namespace std;
+
+
+//______________________________________________________TEE BUFFER_____________________________________________________
+// Stream buffer passing what is written to it on to another one, and keeping a copy
+class TeeBuf : public streambuf
+{
+	streambuf *target;
+	string copy;
+
+protected:
+	int_type overflow(int_type c) override
+	{
+		if (c == traits_type::eof())
+			return traits_type::not_eof(c);
+		copy += traits_type::to_char_type(c);
+		return target->sputc(traits_type::to_char_type(c));
+	}
+
+	streamsize xsputn(const char *text, streamsize count) override
+	{
+		copy.append(text, count);
+		return target->sputn(text, count);
+	}
+
+	int sync() override
+	{
+		return target->pubsync();
+	}
+
+public:
+	TeeBuf(streambuf *passTo): target(passTo) {}
+
+	const string& getCopy() const
+	{
+		return copy;
+	}
+};
+
+
+//_____________________________________________________RESULT CACHE____________________________________________________
+// Results of whole runs kept in a directory, for programs run again on the same input. The language has no source of
+// nondeterminism but read(), so a run is determined by its compiled program, the options that show in its output,
+// and the bytes its reads have looked at. An entry keeps those bytes (the consumed prefix of the input, with the
+// character that has ended the last value), so it serves any input that begins with them. A run that has come to the
+// end of its input (or a value it could not read) has looked at all of it: its entry serves only the same input.
+// Entries are named <key>-<hash of the prefix>-<length of the prefix>, and are written with the checkpoint writer; the
+// file <key> lists the lengths of the prefixes of the entries that have not read their whole input, so a lookup opens
+// files by name instead of listing the directory. A run that is not served is recorded while its output goes out as
+// usual
+class ResultCache
+{
+public:
+	// Result of a run
+	struct result
+	{
+		executionStatus status;
+		string output;
+		string errors;
+		bool failed;													// indicator that the run has ended with an InterpreterError
+		string error;
+	};
+
+private:
+	static const uint32_t RESULT_MAGIC = 0x5352504d;					// "MPRS"
+
+	string directory;
+
+	static string hex(uint64_t value)
+	{
+		char text[17];
+		snprintf(text, sizeof(text), "%016llx", (unsigned long long) value);
+		return text;
+	}
+
+	// Path of the entry of a run with the given key that has looked at the prefix
+	string entryPath(uint64_t key, string_view prefix) const
+	{
+		string name = hex(key) + "-" + hex(fnvHash(prefix.data(), prefix.size())) + "-" + to_string(prefix.size());
+		return (filesystem::path(directory) / name).string();
+	}
+
+	// Path of the index of the key: the lengths of the prefixes its entries that have not read their whole input have
+	// looked at, one on a line
+	string indexPath(uint64_t key) const
+	{
+		return (filesystem::path(directory) / hex(key)).string();
+	}
+
+	// Read the entry of the run with the given key that has looked at the input's first bytes, if it serves the input
+	bool load(uint64_t key, string_view input, size_t length, result &found) const
+	{
+		CheckpointReader image;
+		if (!image.load(entryPath(key, input.substr(0, length))) || image.get<uint32_t>() != RESULT_MAGIC)
+			return false;
+		bool whole = image.get<uint8_t>();
+		string_view consumed = image.getString();
+		if (consumed != input.substr(0, length) || (whole && length != input.size()))
+			return false;
+		found.status = executionStatus(image.get<int32_t>());
+		found.output = string(image.getString());
+		found.errors = string(image.getString());
+		found.failed = image.get<uint8_t>();
+		found.error = string(image.getString());
+		return image.complete();
+	}
+
+public:
+	ResultCache(const string &dir): directory(dir)
+	{
+		error_code ignored;
+		filesystem::create_directories(directory, ignored);
+	}
+
+	// Find the result of a run with the given key on the input. Returns false if there is none. The entries are opened
+	// by name: the one of a run that has read the whole input, and those of the prefixes in the key's index
+	bool find(uint64_t key, string_view input, result &found)
+	{
+		if (load(key, input, input.size(), found))
+			return true;
+		ifstream index(indexPath(key));
+		size_t length;
+		while (index >> length)
+			if (length < input.size() && load(key, input, length, found))
+				return true;
+		return false;
+	}
+
+	// Keep the result of a run with the given key that has looked at the given prefix of its input (the whole input)
+	void add(uint64_t key, string_view consumed, bool whole, const result &run)
+	{
+		CheckpointWriter image;
+		image.put(RESULT_MAGIC);
+		image.put<uint8_t>(whole);
+		image.putString(consumed);
+		image.put<int32_t>(run.status);
+		image.putString(run.output);
+		image.putString(run.errors);
+		image.put<uint8_t>(run.failed);
+		image.putString(run.error);
+		if (!image.save(entryPath(key, consumed)) || whole)				// a cache that cannot be written is only slower
+			return;
+		ifstream known(indexPath(key));
+		size_t length;
+		while (known >> length)
+			if (length == consumed.size())
+				return;
+		ofstream(indexPath(key), ios::app) << consumed.size() << '\n';
+	}
+};
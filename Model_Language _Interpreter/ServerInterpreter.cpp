@@ -0,0 +1,205 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <csignal>
+#include "Interpreter.cpp"
+#include "ThreadPool.cpp"
+#include "ServerProtocol.cpp"
+
+using namespace std;
+
+
+//____________________________________________________PROGRAM CACHE____________________________________________________
+// Compiled programs by the hash of their source, the least recently used one going first when the cache is full.
+// The source is kept as well, so programs with the same hash are told apart
+class ProgramCache
+{
+	struct entry
+	{
+		size_t hash;
+		string source;
+		shared_ptr<const CompiledProgram> program;
+		string warnings;												// warnings of the analysis, sent with every run
+	};
+
+	mutex lock;
+	size_t capacity;
+	list<entry> entries;												// the most recently used first
+	unordered_map<size_t, list<entry>::iterator> index;
+
+public:
+	ProgramCache(size_t size): capacity(max<size_t>(size, 1)) {}
+
+	// Get the compiled program of the source (nullptr if it is not in the cache)
+	shared_ptr<const CompiledProgram> find(size_t hash, const string &source, string &warnings)
+	{
+		lock_guard<mutex> guard(lock);
+		auto it = index.find(hash);
+		if (it == index.end() || it->second->source != source)
+			return nullptr;
+		entries.splice(entries.begin(), entries, it->second);
+		warnings = it->second->warnings;
+		return it->second->program;
+	}
+
+	void add(size_t hash, const string &source, shared_ptr<const CompiledProgram> program, const string &warnings)
+	{
+		lock_guard<mutex> guard(lock);
+		auto it = index.find(hash);
+		if (it != index.end())											// compiled by another request meanwhile, or a collision
+			entries.erase(it->second);
+		else if (entries.size() == capacity)
+		{
+			index.erase(entries.back().hash);
+			entries.pop_back();
+		}
+		entries.push_front(entry {hash, source, move(program), warnings});
+		index[hash] = entries.begin();
+	}
+};
+
+
+//____________________________________________________REQUEST HANDLER__________________________________________________
+// Compile the program, or take it from the cache. Throws InterpreterError if it cannot be compiled
+shared_ptr<const CompiledProgram> getProgram(ProgramCache &cache, const string &source, string &warnings)
+{
+	size_t hash = std::hash<string>()(source);
+	shared_ptr<const CompiledProgram> program = cache.find(hash, source, warnings);
+	if (program)
+		return program;
+
+	ostringstream messages;												// the parser's report of a successful analysis
+	ostringstream warningStream;
+	programStreams streams;
+	streams.out = &messages;
+	streams.err = &warningStream;
+	Interpreter interpreter(source, STREAM_INPUT, nullptr, streams);
+	interpreter.compile();
+	program = interpreter.share();
+	warnings = warningStream.str();
+	cache.add(hash, source, program, warnings);
+	return program;
+}
+
+// Serve one request of the connection: read the program and its input, run it and send back its output and status
+void serve(int fd, ProgramCache &cache, const executionOptions &options)
+{
+	static thread_local ExecutionContext context;						// memory is reused by the runs of a worker
+	context.setOptions(options);
+
+	FrameReader reader(fd);
+	programRequest request;
+	if (!readRequest(reader, request))
+		return;
+	string &source = request.program;
+	string missing;														// program file that cannot be opened
+	if (request.byPath)
+	{
+		ifstream file(source);
+		if (!file)
+			missing = source;
+		source.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+
+	FrameStreamBuf outBuf(fd, "OUT");
+	FrameStreamBuf errBuf(fd, "ERR");
+	ostream out(&outBuf);
+	ostream err(&errBuf);
+	istringstream in(request.input);
+	programStreams streams;
+	streams.in = &in;
+	streams.out = &out;
+	streams.err = &err;
+
+	executionStatus status;
+	try
+	{
+		if (!missing.empty())
+			throw InterpreterError("Cannot open the program file " + missing);
+		string warnings;
+		shared_ptr<const CompiledProgram> program = getProgram(cache, source, warnings);
+		err << warnings;
+		status = context.run(*program, streams);
+	}
+	catch (InterpreterError &error)
+	{
+		err << error.what() << endl;
+		status = EXEC_ERROR;
+	}
+	out.flush();
+	err.flush();
+	sendFrame(fd, "STATUS", to_string(status));
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: ServerInterpreter [--socket PATH] [--threads N] [--cache N] [--fuel N] [--max-string-bytes N]
+//               [--time-limit MS]
+// Serves requests to run programs (see ServerProtocol.cpp) until it is stopped
+int main(int argc, char *argv[])
+{
+	string socketPath = "/tmp/model_interpreter.sock";
+	executionOptions options = executionOptions();
+	int threads = 0;
+	size_t cacheSize = 64;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--socket" && i + 1 < argc)							// path of the Unix domain socket
+			socketPath = argv[++i];
+		else if (arg == "--threads" && i + 1 < argc)					// number of workers (the machine's threads by default)
+			threads = atoi(argv[++i]);
+		else if (arg == "--cache" && i + 1 < argc)						// number of compiled programs kept
+			cacheSize = max(1, atoi(argv[++i]));
+		else if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+		{
+			cerr << "Usage: " << argv[0] << " [--socket PATH] [--threads N] [--cache N] [--fuel N] "
+				 << "[--max-string-bytes N] [--time-limit MS]\n";
+			return 1;
+		}
+	}
+	options.quiet = true;												// the output of a run is only the program's
+
+	int listener = listenOn(socketPath);
+	if (listener < 0)
+	{
+		cerr << "Cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	signal(SIGPIPE, SIG_IGN);											// a client that has gone is noticed by send()
+
+	ProgramCache cache(cacheSize);
+	ThreadPool pool(threads);
+	pool.start();
+	cerr << "Listening on " << socketPath << " with " << pool.size() << " workers" << endl;
+	while (true)
+	{
+		int fd = accept(listener, nullptr, nullptr);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			cerr << "accept: " << strerror(errno) << endl;
+			break;
+		}
+		pool.submit([fd, &cache, &options]
+		{
+			serve(fd, cache, options);
+			close(fd);
+		});
+	}
+	pool.finish();
+	close(listener);
+	return 1;
+}
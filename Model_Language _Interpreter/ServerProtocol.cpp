@@ -0,0 +1,223 @@
+#include <string>
+#include <string_view>
+#include <streambuf>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+//___________________________________________________SERVER PROTOCOL___________________________________________________
+// The interpreter server and its clients talk over a Unix domain socket, one request on each connection. Both ways
+// the data is a sequence of frames: a header line "<TAG> <length>\n" and then that many bytes.
+//   request:	SOURCE (the text of the program) or PATH (the name of a program file on the server's machine), and then
+//				INPUT (the values for read(), may be empty)
+//   response:	OUT (output) and ERR (warnings and errors) frames as the program writes them, and at the end STATUS
+//				(the executionStatus of the run in decimal)
+const size_t MAX_FRAME = 1 << 26;										// longest frame accepted (64 MB)
+
+// Write all the bytes to the socket. Returns false if the other side has gone
+bool writeAll(int fd, const char *data, size_t size)
+{
+	while (size)
+	{
+		ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+		data += written;
+		size -= written;
+	}
+	return true;
+}
+
+bool sendFrame(int fd, string_view tag, string_view data)
+{
+	string header = string(tag) + ' ' + to_string(data.size()) + '\n';
+	return writeAll(fd, header.data(), header.size()) && writeAll(fd, data.data(), data.size());
+}
+
+
+//_____________________________________________________FRAME READER____________________________________________________
+// Buffered reader of the frames coming from a socket
+class FrameReader
+{
+	int fd;
+	char buffer[1 << 16];
+	size_t begin;														// first byte not taken yet
+	size_t end;															// end of the bytes read
+
+	// Read more bytes into the buffer. Returns false at the end of the data
+	bool fill()
+	{
+		if (begin == end)
+			begin = end = 0;
+		if (end == sizeof(buffer))										// only a header line can fill the buffer
+			return false;
+		ssize_t count;
+		do
+			count = read(fd, buffer + end, sizeof(buffer) - end);
+		while (count < 0 && errno == EINTR);
+		if (count <= 0)
+			return false;
+		end += count;
+		return true;
+	}
+
+public:
+	FrameReader(int socket): fd(socket), begin(0), end(0) {}
+
+	// Read the next frame. Returns false at the end of the data or if the frame is malformed
+	bool next(string &tag, string &data)
+	{
+		size_t lineEnd;
+		while ((lineEnd = string_view(buffer + begin, end - begin).find('\n')) == string_view::npos)
+		{
+			if (begin > 0)												// make room for the rest of the line
+			{
+				memmove(buffer, buffer + begin, end - begin);
+				end -= begin;
+				begin = 0;
+			}
+			if (!fill())
+				return false;
+		}
+		string_view header(buffer + begin, lineEnd);
+		begin += lineEnd + 1;
+		size_t space = header.find(' ');
+		if (space == string_view::npos)
+			return false;
+		tag = string(header.substr(0, space));
+		size_t length = strtoull(string(header.substr(space + 1)).c_str(), nullptr, 10);
+		if (length > MAX_FRAME)
+			return false;
+
+		data.clear();
+		data.reserve(length);
+		while (data.size() < length)
+		{
+			if (begin == end && !fill())
+				return false;
+			size_t count = min(length - data.size(), end - begin);
+			data.append(buffer + begin, count);
+			begin += count;
+		}
+		return true;
+	}
+};
+
+
+//______________________________________________________REQUESTS_______________________________________________________
+// Request read from a connection: the program (its text, or the path of its file) and the values for its read()
+struct programRequest
+{
+	bool byPath;														// indicator that the program is the path of a file
+	string program;
+	string input;
+};
+
+// Read the frames of the request. Returns false if they are missing or malformed
+bool readRequest(FrameReader &reader, programRequest &request)
+{
+	string tag;
+	if (!reader.next(tag, request.program) || (tag != "SOURCE" && tag != "PATH"))
+		return false;
+	request.byPath = tag == "PATH";
+	return reader.next(tag, request.input) && tag == "INPUT";
+}
+
+
+//___________________________________________________FRAME STREAMBUF___________________________________________________
+// Stream buffer sending what is written to it as frames with the given tag, whenever the buffer fills up or the
+// stream is flushed. Once the other side has gone, the output is dropped
+class FrameStreamBuf : public streambuf
+{
+	int fd;
+	string tag;
+	char buffer[1 << 12];
+	bool failed;
+
+	bool sendBuffer()
+	{
+		if (pptr() > pbase() && !failed)
+			failed = !sendFrame(fd, tag, string_view(pbase(), pptr() - pbase()));
+		setp(buffer, buffer + sizeof(buffer));
+		return !failed;
+	}
+
+protected:
+	int_type overflow(int_type c) override
+	{
+		sendBuffer();
+		if (c != traits_type::eof())
+		{
+			*pptr() = traits_type::to_char_type(c);
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+	int sync() override
+	{
+		return sendBuffer() ? 0 : -1;
+	}
+
+public:
+	FrameStreamBuf(int socket, string frameTag): fd(socket), tag(move(frameTag)), failed(false)
+	{
+		setp(buffer, buffer + sizeof(buffer));
+	}
+};
+
+
+//_______________________________________________________SOCKETS_______________________________________________________
+bool socketAddress(const string &path, sockaddr_un &address)
+{
+	if (path.size() >= sizeof(address.sun_path))
+		return false;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path.c_str());
+	return true;
+}
+
+// Listen on the socket with the given path (replacing a socket left there). Returns -1 on failure
+int listenOn(const string &path)
+{
+	sockaddr_un address;
+	if (!socketAddress(path, address))
+		return -1;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+	unlink(path.c_str());
+	if (bind(fd, (sockaddr*) &address, sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Connect to the socket with the given path. Returns -1 on failure
+int connectTo(const string &path)
+{
+	sockaddr_un address;
+	if (!socketAddress(path, address))
+		return -1;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+	if (connect(fd, (sockaddr*) &address, sizeof(address)) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
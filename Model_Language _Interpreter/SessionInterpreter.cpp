@@ -0,0 +1,166 @@
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <memory>
+#include "Interpreter.cpp"
+
+using namespace std;
+
+
+//____________________________________________________SESSION ENTRY____________________________________________________
+// Session of the event loop and the output it has written, which is printed line by line with the session's name
+struct sessionEntry
+{
+	unique_ptr<ostringstream> output;
+	unique_ptr<Session> session;
+	size_t printed;														// characters of the output printed so far
+	executionStatus status;												// status of the finished session
+};
+
+// Print the complete lines the session has written since the last time (all of them when it has finished)
+void printOutput(const string &name, sessionEntry &entry, bool finished)
+{
+	string text = entry.output->str();
+	size_t end = finished ? text.size() : text.rfind('\n') + 1;		// rfind() gives npos + 1 = 0 when there is no line
+	while (entry.printed < end)
+	{
+		size_t next = text.find('\n', entry.printed);
+		if (next == string::npos || next >= end)
+			next = end;
+		cout << name << ": " << string_view(text).substr(entry.printed, next - entry.printed) << '\n';
+		entry.printed = min(next + 1, end);
+	}
+	if (entry.printed > 1 << 16)										// drop what has been printed
+	{
+		entry.output->str(text.substr(entry.printed));
+		entry.output->seekp(0, ios::end);
+		entry.printed = 0;
+	}
+}
+
+// Run the session until it needs input or ends. Returns false if it has ended
+bool stepSession(const string &name, sessionEntry &entry)
+{
+	stepResult result;
+	try
+	{
+		result = entry.session->step();
+		entry.status = entry.session->getStatus();
+	}
+	catch (InterpreterError &error)
+	{
+		*entry.output << error.what() << endl;
+		result = STEP_FINISHED;
+		entry.status = EXEC_ERROR;
+	}
+	printOutput(name, entry, result == STEP_FINISHED);
+	if (result == STEP_FINISHED)
+		cout << "[" << name << " finished with status " << entry.status << "]\n";
+	return result == STEP_NEEDS_INPUT;
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: SessionInterpreter [--fuel N] [--max-string-bytes N] [--time-limit MS] program < events
+// Every line of the input is an event of a session: "name values..." feeds the values to the read() of the session
+// (opened when its name is first seen), and a line with the name alone ends its input. All the sessions are run on
+// one thread, each one until it reaches a read() with no value to take
+int main(int argc, char *argv[])
+{
+	string fileName;
+	executionOptions options = executionOptions();
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+			fileName = arg;
+	}
+	if (fileName.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--fuel N] [--max-string-bytes N] [--time-limit MS] program < events\n";
+		return 1;
+	}
+	options.quiet = true;
+
+	programStreams streams;
+	streams.out = &cerr;
+	unique_ptr<Interpreter> interpreter;
+	try
+	{
+		interpreter = make_unique<Interpreter>(ProgramSource::fromFile(fileName), STREAM_INPUT, nullptr, streams);
+		interpreter->setOptions(options);
+		interpreter->compile();
+	}
+	catch (InterpreterError &error)
+	{
+		cerr << error.what() << endl;
+		return 1;
+	}
+
+	Arena arena;														// shared by the sessions (they take turns)
+	map<string, sessionEntry> sessions;
+	vector<string> opened;												// names of the sessions in the order they were opened
+	int failed = 0;
+
+	auto finish = [&](map<string, sessionEntry>::iterator it)
+	{
+		failed += it->second.status != EXEC_OK;
+		sessions.erase(it);
+	};
+
+	string line;
+	while (getline(cin, line))
+	{
+		istringstream event(line);
+		string name;
+		if (!(event >> name))
+			continue;
+		string values;
+		getline(event >> ws, values);
+
+		auto it = sessions.find(name);
+		if (it == sessions.end())
+		{
+			sessionEntry entry;
+			entry.output = make_unique<ostringstream>();
+			programStreams sessionStreams;
+			sessionStreams.out = entry.output.get();
+			sessionStreams.err = entry.output.get();
+			entry.session = interpreter->openSession(arena, sessionStreams);
+			entry.printed = 0;
+			entry.status = EXEC_OK;
+			it = sessions.emplace(name, move(entry)).first;
+			opened.push_back(name);
+			if (!stepSession(name, it->second))							// the program may run to its end without reading
+			{
+				finish(it);
+				continue;
+			}
+		}
+
+		if (values.empty())
+			it->second.session->closeInput();
+		else
+			it->second.session->feed(values);
+		if (!stepSession(name, it->second))
+			finish(it);
+	}
+
+	for (auto &name : opened)											// the input is over for every session
+	{
+		auto it = sessions.find(name);
+		if (it == sessions.end())
+			continue;
+		it->second.session->closeInput();
+		stepSession(name, it->second);
+		finish(it);
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+#include "Arena.cpp"
+
+using namespace std;
+
+
+//_______________________________________________STRING MEMORY LIMIT ERROR_____________________________________________
+// Thrown when the heap buffers of the string values would take more bytes than the run is allowed
+class StringLimitError : public exception
+{
+public:
+	const char* what() const noexcept override
+	{
+		return "the string values take more memory than allowed";
+	}
+};
+
+
+//____________________________________________________STRING VALUE_____________________________________________________
+// Runtime representation of the model language strings. Short strings are kept in place, long ones share an immutable
+// reference-counted heap buffer, and string literals are views of the string constants table (which keeps every
+// constant once, so two literals are equal only if they are the same entry). Strings given by a host program are views
+// of its memory, which it keeps for the run.
+// A heap buffer owned by a single value may be appended to in place: it then works as a builder with spare capacity
+// growing geometrically, which makes repeated concatenation linear.
+// Heap buffers are allocated from the memory resource of the current run (its arena).
+class StringValue
+{
+	static const size_t INLINE_CAPACITY = 22;							// longest string kept in place
+
+	enum storage : unsigned char
+	{
+		INLINE,															// characters are stored in the value itself
+		HEAP,															// characters are stored in a shared heap buffer
+		CONSTANT,														// the value is a view of a string constants table entry
+		EXTERNAL														// the value is a view of the host's memory
+	};
+
+	struct Buffer														// heap buffer shared by reference counting (immutable while shared)
+	{
+		int references;
+		size_t length;
+		size_t capacity;
+		char data[1];
+	};
+
+	union
+	{
+		char chars[INLINE_CAPACITY];
+		Buffer *buffer;
+		const string *constant;
+		struct
+		{
+			const char *text;
+			size_t length;
+		} hostView;
+	};
+	unsigned char inlineLength;
+	storage kind;
+
+	static thread_local pmr::memory_resource *memory;					// where heap buffers are allocated (by the run on this thread)
+	static thread_local size_t liveBytes;								// capacity of all the heap buffers in use
+	static thread_local size_t byteLimit;								// maximum of liveBytes
+
+	// Allocate a heap buffer for a string of the given length
+	static Buffer* allocate(size_t length, size_t capacity)
+	{
+		if (capacity > byteLimit - liveBytes)
+			throw StringLimitError();
+		liveBytes += capacity;
+		Buffer *newBuffer = (Buffer*) memory->allocate(sizeof(Buffer) + capacity, alignof(Buffer));
+		newBuffer->references = 1;
+		newBuffer->length = length;
+		newBuffer->capacity = capacity;
+		return newBuffer;
+	}
+
+	// Return a heap buffer to the memory resource
+	static void deallocate(Buffer *oldBuffer)
+	{
+		liveBytes -= oldBuffer->capacity;
+		memory->deallocate(oldBuffer, sizeof(Buffer) + oldBuffer->capacity, alignof(Buffer));
+	}
+
+	// Make the value own a copy of the given characters
+	void assign(const char *text, size_t length)
+	{
+		if (length <= INLINE_CAPACITY)
+		{
+			memcpy(chars, text, length);
+			inlineLength = length;
+			kind = INLINE;
+		}
+		else
+		{
+			buffer = allocate(length, length);
+			memcpy(buffer->data, text, length);
+			kind = HEAP;
+		}
+	}
+
+	// Drop the reference to the heap buffer (if any)
+	void release()
+	{
+		if (kind == HEAP && --buffer->references == 0)
+			deallocate(buffer);
+		inlineLength = 0;
+		kind = INLINE;
+	}
+
+	// Take the contents of another value, leaving it empty
+	void steal(StringValue &other)
+	{
+		memcpy((void*) this, (void*) &other, sizeof(StringValue));
+		other.inlineLength = 0;
+		other.kind = INLINE;
+	}
+
+public:
+	// Set the memory resource for heap buffers and the capacity of the buffers in use. Values allocated from the
+	// previous one must be gone by then, unless it is a run going on from where it has stopped (with its own capacity)
+	static void setMemory(pmr::memory_resource *resource, size_t live=0)
+	{
+		memory = resource;
+		liveBytes = live;
+	}
+
+	// Capacity of all the heap buffers in use
+	static size_t getLiveBytes()
+	{
+		return liveBytes;
+	}
+
+	// Limit the capacity of all the heap buffers in use (0 - no limit). Going over it throws StringLimitError
+	static void setByteLimit(size_t limit)
+	{
+		byteLimit = limit ? limit : SIZE_MAX;
+	}
+
+	StringValue(): inlineLength(0), kind(INLINE) {}
+
+	// View of a string constants table entry (no copy)
+	explicit StringValue(const string *constantEntry): constant(constantEntry), inlineLength(0), kind(CONSTANT) {}
+
+	// Copy of arbitrary characters
+	explicit StringValue(string_view text)
+	{
+		assign(text.data(), text.size());
+	}
+
+	// View of characters kept by the host as long as the value may be used (no copy)
+	static StringValue external(string_view text)
+	{
+		StringValue value;
+		value.hostView = {text.data(), text.size()};
+		value.kind = EXTERNAL;
+		return value;
+	}
+
+	StringValue(const StringValue &other)
+	{
+		memcpy((void*) this, (void*) &other, sizeof(StringValue));
+		if (kind == HEAP)
+			buffer->references++;
+	}
+
+	StringValue(StringValue &&other) noexcept
+	{
+		steal(other);
+	}
+
+	StringValue& operator = (const StringValue &other)
+	{
+		if (this != &other)
+		{
+			if (other.kind == HEAP)
+				other.buffer->references++;
+			release();
+			memcpy((void*) this, (void*) &other, sizeof(StringValue));
+		}
+		return *this;
+	}
+
+	StringValue& operator = (StringValue &&other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			steal(other);
+		}
+		return *this;
+	}
+
+	~StringValue()
+	{
+		release();
+	}
+
+	const char* data() const
+	{
+		switch (kind)
+		{
+			case HEAP:
+				return buffer->data;
+			case CONSTANT:
+				return constant->data();
+			case EXTERNAL:
+				return hostView.text;
+			default:
+				return chars;
+		}
+	}
+
+	size_t size() const
+	{
+		switch (kind)
+		{
+			case HEAP:
+				return buffer->length;
+			case CONSTANT:
+				return constant->size();
+			case EXTERNAL:
+				return hostView.length;
+			default:
+				return inlineLength;
+		}
+	}
+
+	string_view view() const
+	{
+		return string_view(data(), size());
+	}
+
+	// Check if both values share the same heap buffer
+	bool sharesBuffer(const StringValue &other) const
+	{
+		return kind == HEAP && other.kind == HEAP && buffer == other.buffer;
+	}
+
+	// Concatenation: the value's own buffer is extended in place when nobody else refers to it
+	void append(const StringValue &piece)
+	{
+		size_t length = size();
+		size_t pieceLength = piece.size();
+		size_t newLength = length + pieceLength;
+
+		if (kind == HEAP && buffer->references == 1)					// the buffer is a builder owned by this value
+		{
+			if (newLength > buffer->capacity)
+			{
+				Buffer *newBuffer = allocate(length, max(newLength, 2 * buffer->capacity));
+				memcpy(newBuffer->data, buffer->data, length);
+				deallocate(buffer);
+				buffer = newBuffer;
+			}
+			memcpy(buffer->data + length, piece.data(), pieceLength);
+			buffer->length = newLength;
+		}
+		else if (newLength <= INLINE_CAPACITY)							// the result fits in place
+		{
+			char text[INLINE_CAPACITY];
+			memcpy(text, data(), length);
+			memcpy(text + length, piece.data(), pieceLength);
+			release();
+			memcpy(chars, text, newLength);
+			inlineLength = newLength;
+		}
+		else															// a new buffer is made for the result
+		{
+			Buffer *newBuffer = allocate(newLength, newLength);
+			memcpy(newBuffer->data, data(), length);
+			memcpy(newBuffer->data + length, piece.data(), pieceLength);
+			release();
+			buffer = newBuffer;
+			kind = HEAP;
+		}
+	}
+
+	// Comparison (constants and shared buffers are compared by address first)
+	friend bool operator == (const StringValue &left, const StringValue &right)
+	{
+		if (left.kind == CONSTANT && right.kind == CONSTANT)
+			return left.constant == right.constant;
+		if (left.kind == HEAP && right.kind == HEAP && left.buffer == right.buffer)
+			return true;
+		return left.view() == right.view();
+	}
+
+	friend bool operator != (const StringValue &left, const StringValue &right)
+	{
+		return !(left == right);
+	}
+
+	friend bool operator < (const StringValue &left, const StringValue &right)
+	{
+		return left.view() < right.view();
+	}
+
+	friend bool operator > (const StringValue &left, const StringValue &right)
+	{
+		return left.view() > right.view();
+	}
+
+	friend ostream& operator << (ostream &out, const StringValue &s)
+	{
+		out.write(s.data(), s.size());
+		return out;
+	}
+};
+
+thread_local pmr::memory_resource *StringValue::memory = pmr::new_delete_resource();
+thread_local size_t StringValue::liveBytes = 0;
+thread_local size_t StringValue::byteLimit = SIZE_MAX;
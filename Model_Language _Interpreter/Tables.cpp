@@ -1,143 +1,145 @@
-#include <vector>
-#include <algorithm>
-#include "Lexeme.cpp"
-
-using namespace std;
-
-
-//_____________________________________________________IDENTIFIER______________________________________________________
-class Identifier
-{
-	string name;
-	lexemeType type;
-	
-	bool declared;														// identificator that identifier is already declared
-	bool assigned;														// identificator that identifier is already assigned a value
-	int value;
-	string strValue;
-	
-	bool label;															// identificator that identifier is a label
-	int address;
-
-public:
-	Identifier(const string n): declared(false), assigned(false), label(false), name(n)
-	{
-		value = -1;
-		address = -1;
-	}
-	
-	string getName()
-	{
-		return name;
-	}
-	
-	void setName(const string newName)
-	{
-		name = newName;
-	}
-	
-	bool isDeclared()
-	{
-		return declared;
-	}
-	
-	void setDeclare()
-	{
-		declared = true;
-	}
-	
-	lexemeType getType()
-	{
-		return type;
-	}
-	
-	void setType(lexemeType newType)
-	{
-		type = newType;
-	}
-	
-	bool isAssigned()
-	{
-		return assigned;
-	}
-	
-	void setAssign()
-	{
-		assigned = true;
-	}
-	
-	int getValue()
-	{
-		return value;
-	}
-	
-	string getStringValue()
-	{
-		return strValue;
-	}
-	
-	void setValue(int newValue)
-	{
-		value = newValue;
-	}
-	
-	void setValue(string newStrValue)
-	{
-		strValue = newStrValue;
-	}
-	
-	bool isLabel()
-	{
-		return label;
-	}
-	
-	void setAsLabel()
-	{
-		label = true;
-		declared = true;
-	}
-
-	int getAddress()
-	{
-		return address;
-	}
-
-	void setAddress(int newAddress)
-	{
-		address = newAddress;
-	}
-};
-
-//_______________________________________________________TABLES________________________________________________________
-vector <Identifier> identTable;											// Identifiers table (vectorised)
-vector <string> strConstTable;	    									// String constants table (vectorised)
-
-// Filling the identifier table with unique entries
-int addUniqueIdent(const string name)
-{
-	auto isPresent = [name](Identifier id) { return id.getName() == name; };
-    auto it = std::find_if(identTable.begin(), identTable.end(), isPresent);
-        
-    if (it != identTable.end())                                         // if an identifier with this name is already present in the table:
-        return distance(identTable.begin(), it);                        // return its position in the table
-    identTable.push_back(Identifier(name));				  				// else: add the ID in the end of the table
-    return identTable.size() - 1;							    	    // and return its position
-}
-
-// Filling the sting constants table with unique entries
-int addUniqueStrConst(const string str)
-{
-	auto it = find(strConstTable.begin(), strConstTable.end(), str);
-
-    if (it != strConstTable.end())            	    		    		// if the current string is already present in the table:
-        return distance(strConstTable.begin(), it);   	    	      	// return its position in the table
-    strConstTable.push_back(str);             					    	// else: add the string in the end of the table
-    return strConstTable.size() - 1;      					        	// and return its position
-}
-
-// Clear both tables
-void clearTables()
-{
-	identTable.clear();
-	strConstTable.clear();
+#include <vector>
+#include <algorithm>
+#include "Lexeme.cpp"
+#include "StringValue.cpp"
+
+using namespace std;
+
+
+//_____________________________________________________IDENTIFIER______________________________________________________
+class Identifier
+{
+	pmr::string name;													// the name is kept in the memory of the run
+	lexemeType type;
+	
+	bool declared;														// identificator that identifier is already declared
+	bool assigned;														// identificator that identifier is already assigned a value
+	int value;															// position a label leads to in the RPN
+	
+	bool label;															// identificator that identifier is a label
+	int address;
+
+public:
+	Identifier(const string &n, pmr::memory_resource *memory): declared(false), assigned(false), label(false), name(n, memory)
+	{
+		type = LEX_NULL;												// labels never get a type
+		value = -1;
+		address = -1;
+	}
+	
+	string getName()
+	{
+		return string(name);
+	}
+	
+	bool hasName(const string &n)
+	{
+		return string_view(name) == n;
+	}
+	
+	void setName(const string newName)
+	{
+		name = newName;
+	}
+	
+	bool isDeclared()
+	{
+		return declared;
+	}
+	
+	void setDeclare()
+	{
+		declared = true;
+	}
+
+	void clearDeclare()
+	{
+		declared = false;
+	}
+	
+	lexemeType getType()
+	{
+		return type;
+	}
+	
+	void setType(lexemeType newType)
+	{
+		type = newType;
+	}
+	
+	bool isAssigned()
+	{
+		return assigned;
+	}
+	
+	void setAssign()
+	{
+		assigned = true;
+	}
+	
+	int getValue()
+	{
+		return value;
+	}
+	
+	void setValue(int newValue)
+	{
+		value = newValue;
+	}
+	
+	bool isLabel()
+	{
+		return label;
+	}
+	
+	void setAsLabel()
+	{
+		label = true;
+		declared = true;
+	}
+
+	int getAddress()
+	{
+		return address;
+	}
+
+	void setAddress(int newAddress)
+	{
+		address = newAddress;
+	}
+};
+
+//_______________________________________________________TABLES________________________________________________________
+// Every thread has tables of its own, so programs may be interpreted on several threads at once
+thread_local vector <Identifier> identTable;							// Identifiers table (vectorised)
+thread_local vector <string> strConstTable;	    						// String constants table (vectorised)
+
+// Filling the identifier table with unique entries (names are kept in the given memory)
+int addUniqueIdent(const string &name, pmr::memory_resource *memory)
+{
+	auto isPresent = [&name](Identifier &id) { return id.hasName(name); };
+    auto it = std::find_if(identTable.begin(), identTable.end(), isPresent);
+        
+    if (it != identTable.end())                                         // if an identifier with this name is already present in the table:
+        return distance(identTable.begin(), it);                        // return its position in the table
+    identTable.push_back(Identifier(name, memory));		  				// else: add the ID in the end of the table
+    return identTable.size() - 1;							    	    // and return its position
+}
+
+// Filling the sting constants table with unique entries
+int addUniqueStrConst(const string str)
+{
+	auto it = find(strConstTable.begin(), strConstTable.end(), str);
+
+    if (it != strConstTable.end())            	    		    		// if the current string is already present in the table:
+        return distance(strConstTable.begin(), it);   	    	      	// return its position in the table
+    strConstTable.push_back(str);             					    	// else: add the string in the end of the table
+    return strConstTable.size() - 1;      					        	// and return its position
+}
+
+// Clear both tables
+void clearTables()
+{
+	identTable.clear();
+	strConstTable.clear();
 }
\ No newline at end of file
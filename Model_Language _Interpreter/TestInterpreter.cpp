@@ -1,234 +1,356 @@
-#include <iostream>
-#include <fstream>
-#include <conio.h>
-#include "Interpreter.cpp"
-
-using namespace std;
-
-void getExpectedResults(int testNumber)
-{
-	int x, y, z, i, j;
-
-	cout << "No lexical, syntax or semantic issues. Your program is flawless.\n";
-	cout << "Beginning execution...\n\n";
-	switch (testNumber)
-	{
-		case 0:
-			cout << "Hello, World!" << '\n';
-			break;
-		
-		case 1:
-			cout << "Enter any integer value: *your int here*" << "\n\n"
-				 << "Enter any string value: *your string here*" << "\n\n"
-				 << "Enter any boolean value: *your bool here*" << "\n\n"
-				 << "Your integer value: *your int here*" << '\n'
-				 << "Your string value: *your string here*" << '\n'
-				 << "Your boolean value: *your bool here*" << '\n';
-			break;
-
-		case 2:
-			cout << "Logical addition:\n";
-			cout << "  " << true << " OR " << true << " = " << true || true << '\n';
-			cout << "  " << true << " OR " << false << " = " << true || false << '\n';
-			cout << "  " << false << " OR " << true << " = " << false || true << '\n';
-			cout << "  " << false << " OR " << false << " = " << false || false << '\n';
-
-			cout << "\nLogical multiplication:\n";
-			cout << "  " << true << " AND " << true << " = " << true && true << '\n';
-			cout << "  " << true << " AND " << false << " = " << true && false << '\n';
-			cout << "  " << false << " AND " << true << " = " << false && true << '\n';
-			cout << "  " << false << " AND " << false << " = " << false && false << '\n';
-			
-			cout << "\nLogical reverse:\n";
-			cout << "  not " << true << " = " << !true << '\n';
-			cout <<"  not " << false << " = " << !false << '\n';
-			break;
-		
-		case 3:
-			x = 5;
-			y = 10;
-			
-			if (x > y)
-				cout << x << " is greater than " << y << '\n';
-			else
-				cout << x << " is less or equal than " << y << '\n';
-			
-			x = 10;
-			if (x > y)
-				cout << x << " is greater than " << y << '\n';
-			else if (x < y)
-				cout << x << " is less than " << y << '\n';
-			else
-				cout << x << " and " << y << " are equal" << '\n';
-			break;
-
-		case 4:
-			x = 10;
-			y = 10;
-			while ((x <= 30) || (y > 5))
-			{
-				x = x + 2;
-				y = y - 1;
-			}
-			cout << "x = " << x << "\ny = " << y << "\n\n";
-
-			while ((x >= 5) && (y < 20))
-			{
-				x = x - 2;
-				y = y + 1;
-			}
-			cout << "x = " << x << "\ny = " << y << '\n';
-			break;
-		
-		case 5:
-			x = 10;
-			y = 10;
-			for (int i=0; i<x; i++)
-			{
-				x = x - 2;
-				y = y + 1;
-			}
-			cout << "x = " << x << "\ny = " << y << '\n';
-			break;
-
-		case 6:
-			x = 5;
-			i = 1;
-			for (; i<=9999; i++)
-			{
-				x = x * 2;
-				if (x > 100)
-					break;
-			}
-			cout << "x = " << x << "\ni = " << i << '\n';
-			break;
-
-		case 7:
-			x = 5;
-			y = 7;
-			z = 8;
-			goto Label;
-
-		Label:
-			x++;
-			y--;
-			cout << "x = " << x << "\ny = " << y << "\n\n";
-			x++;
-			if (x < 10)
-				goto Label;	
-			break;
-
-		case 8:
-			cout << "Uncommented section\nStart:\n";
-			x = 10;
-			y = 10;
-			z = 10;
-			for(int i=0; i<x; i++)
-			{
-				x = x - 2;
-				y = y + 1;
-			}
-			cout << "x = " << x << "\ny = " << y << "\nz = " << z << '\n';
-			cout << "End\n\n";
-			cout << "Commented section\nStart:\n";
-
-		//	cout << "This is a commented section!\n";
-
-		/*	
-			if(x < 5)
-				x = x + 1;
-			else
-				x = x - 1;
-			cout << "x = " << x << "\ny = " << y << "\nz = " << z << '\n';
-		*/
-
-			cout << "End\n";
-			break;
-
-		default:
-			break;
-	}
-	cout << "\nExecution complete!\n";
-}
-
-
-int main()
-{
-	string programName;
-	string tests[] = {
-		"tests\\write_test",
-		"tests\\read_test",
-		"tests\\bool_test",
-		"tests\\if_test",
-		"tests\\while_test",
-		"tests\\for_test",
-		"tests\\break_test",
-		"tests\\goto_test",
-		"tests\\comment_test",
-
-		"tests/write_test",
-		"tests/read_test",
-		"tests/bool_test",
-		"tests/if_test",
-		"tests/while_test",
-		"tests/for_test",
-		"tests/break_test",
-		"tests/goto_test",
-		"tests/comment_test"
-	};
-	int amount = 9;
-	bool isTest = 0;
-	int testNum;
-	char input;
-
-//=====================================EXPECTED RESULT=====================================
-//======================================ACTUAL RESULT======================================
-	
-	system("cls");
-	cout << "Enter code file name: ";
-	cin >> programName;
-
-	ifstream f(programName);
-	while (!f.good())
-	{
-		cout << "Cannot open file \'" << programName << "\'. Please try again.\n" << endl;
-		cout << "Enter code file name: ";
-		cin >> programName;
-		f = ifstream(programName);
-	}
-
-	for (int i=0; i<amount*2; i++)
-	{
-		if (programName == tests[i])
-		{
-			isTest = 1;
-			testNum = i % amount + 1;
-		}
-	}
-
-	system("cls");
-	if (isTest)
-	{
-		system("cls");
-		cout << "==========================================TEST " << testNum << "=========================================\n\n";
-		cout << ".....................................Expexted result.....................................\n";
-		
-		getExpectedResults(testNum - 1);
-		
-		cout << "\n......................................Actual result......................................\n";
-		
-		Interpreter interpreter(programName);
-		interpreter.interpret();
-		
-		cout << "\n=========================================================================================\n\n";
-	}
-	else
-	{
-		Interpreter interpreter(programName);
-		interpreter.interpret();
-	}
-	cout << "Press any key to finish";
-	input = getch();
-	system("cls");
-	return 0;
-}
+#include <iostream>
+#include <fstream>
+#include <conio.h>
+#include "Interpreter.cpp"
+
+using namespace std;
+
+void getExpectedResults(int testNumber)
+{
+	int x, y, z, i, j;
+
+	cout << "No lexical, syntax or semantic issues. Your program is flawless.\n";
+	cout << "Beginning execution...\n\n";
+	switch (testNumber)
+	{
+		case 0:
+			cout << "Hello, World!" << '\n';
+			break;
+		
+		case 1:
+			cout << "Enter any integer value: *your int here*" << "\n\n"
+				 << "Enter any string value: *your string here*" << "\n\n"
+				 << "Enter any boolean value: *your bool here*" << "\n\n"
+				 << "Your integer value: *your int here*" << '\n'
+				 << "Your string value: *your string here*" << '\n'
+				 << "Your boolean value: *your bool here*" << '\n';
+			break;
+
+		case 2:
+			cout << "Logical addition:\n";
+			cout << "  " << true << " OR " << true << " = " << true || true << '\n';
+			cout << "  " << true << " OR " << false << " = " << true || false << '\n';
+			cout << "  " << false << " OR " << true << " = " << false || true << '\n';
+			cout << "  " << false << " OR " << false << " = " << false || false << '\n';
+
+			cout << "\nLogical multiplication:\n";
+			cout << "  " << true << " AND " << true << " = " << true && true << '\n';
+			cout << "  " << true << " AND " << false << " = " << true && false << '\n';
+			cout << "  " << false << " AND " << true << " = " << false && true << '\n';
+			cout << "  " << false << " AND " << false << " = " << false && false << '\n';
+			
+			cout << "\nLogical reverse:\n";
+			cout << "  not " << true << " = " << !true << '\n';
+			cout <<"  not " << false << " = " << !false << '\n';
+			break;
+		
+		case 3:
+			x = 5;
+			y = 10;
+			
+			if (x > y)
+				cout << x << " is greater than " << y << '\n';
+			else
+				cout << x << " is less or equal than " << y << '\n';
+			
+			x = 10;
+			if (x > y)
+				cout << x << " is greater than " << y << '\n';
+			else if (x < y)
+				cout << x << " is less than " << y << '\n';
+			else
+				cout << x << " and " << y << " are equal" << '\n';
+			break;
+
+		case 4:
+			x = 10;
+			y = 10;
+			while ((x <= 30) || (y > 5))
+			{
+				x = x + 2;
+				y = y - 1;
+			}
+			cout << "x = " << x << "\ny = " << y << "\n\n";
+
+			while ((x >= 5) && (y < 20))
+			{
+				x = x - 2;
+				y = y + 1;
+			}
+			cout << "x = " << x << "\ny = " << y << '\n';
+			break;
+		
+		case 5:
+			x = 10;
+			y = 10;
+			for (int i=0; i<x; i++)
+			{
+				x = x - 2;
+				y = y + 1;
+			}
+			cout << "x = " << x << "\ny = " << y << '\n';
+			break;
+
+		case 6:
+			x = 5;
+			i = 1;
+			for (; i<=9999; i++)
+			{
+				x = x * 2;
+				if (x > 100)
+					break;
+			}
+			cout << "x = " << x << "\ni = " << i << '\n';
+			break;
+
+		case 7:
+			x = 5;
+			y = 7;
+			z = 8;
+			goto Label;
+
+		Label:
+			x++;
+			y--;
+			cout << "x = " << x << "\ny = " << y << "\n\n";
+			x++;
+			if (x < 10)
+				goto Label;	
+			break;
+
+		case 8:
+			cout << "Uncommented section\nStart:\n";
+			x = 10;
+			y = 10;
+			z = 10;
+			for(int i=0; i<x; i++)
+			{
+				x = x - 2;
+				y = y + 1;
+			}
+			cout << "x = " << x << "\ny = " << y << "\nz = " << z << '\n';
+			cout << "End\n\n";
+			cout << "Commented section\nStart:\n";
+
+		//	cout << "This is a commented section!\n";
+
+		/*	
+			if(x < 5)
+				x = x + 1;
+			else
+				x = x - 1;
+			cout << "x = " << x << "\ny = " << y << "\nz = " << z << '\n';
+		*/
+
+			cout << "End\n";
+			break;
+
+		case 9:
+			x = ((1 + 1));												// the test nests these parentheses 100000 levels deep
+			cout << "x = " << x << '\n';
+			break;
+
+		case 10:
+			x = 84;
+			y = 36;
+			z = 1;														// the calls of gcd, each one taking a step
+			while (y != 0)
+			{
+				i = x % y;
+				x = y;
+				y = i;
+				z++;
+			}
+			cout << "gcd(84, 36) = " << x << ", calls = " << z << '\n';
+
+			x = 0;
+			y = 1;
+			for (i = 0; i < 15; i++)
+			{
+				j = x + y;
+				x = y;
+				y = j;
+			}
+			cout << "fib(15) = " << x << '\n';
+
+			for (i = 0; i < 10; i++)
+				cout << "-=";
+			cout << '\n';
+
+			cout << "even(10) = " << (10 % 2 == 0 ? "true" : "false")
+				 << ", even(7) = " << (7 % 2 == 0 ? "true" : "false") << '\n';
+			break;
+
+		default:
+			break;
+	}
+	cout << "\nExecution complete!\n";
+}
+
+
+int main(int argc, char *argv[])
+{
+	string programName;
+	inputMode mode = STREAM_INPUT;
+	bool arenaStats = false;
+	bool pipelined = false;
+	int lexingThreads = 0;
+	string resultCache;
+	executionOptions options = executionOptions();
+	executionStatus status = EXEC_OK;
+	string tests[] = {
+		"tests\\write_test",
+		"tests\\read_test",
+		"tests\\bool_test",
+		"tests\\if_test",
+		"tests\\while_test",
+		"tests\\for_test",
+		"tests\\break_test",
+		"tests\\goto_test",
+		"tests\\comment_test",
+		"tests\\nesting_test",
+		"tests\\function_test",
+
+		"tests/write_test",
+		"tests/read_test",
+		"tests/bool_test",
+		"tests/if_test",
+		"tests/while_test",
+		"tests/for_test",
+		"tests/break_test",
+		"tests/goto_test",
+		"tests/comment_test",
+		"tests/nesting_test",
+		"tests/function_test"
+	};
+	int amount = 11;
+	bool isTest = 0;
+	int testNum;
+	char input;
+
+//=====================================EXPECTED RESULT=====================================
+//======================================ACTUAL RESULT======================================
+	
+	// Command line: TestInterpreter [--fast-input] [--arena-stats] [--checked] [--trace] [--op-stats] [--fuel N]
+	//                            [--max-string-bytes N] [--time-limit MS] [--pipelined] [--lex-threads N]
+	//                            [--checkpoint FILE] [--checkpoint-interval MS] [--resume] [--result-cache DIR]
+	//                            [code file name]
+	for (int i=1; i<argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--fast-input")										// read() values are tokenised from large blocks of stdin
+			mode = BLOCK_INPUT;
+		else if (arg == "--arena-stats")								// report the peak memory of the run
+			arenaStats = true;
+		else if (arg == "--checked")									// check the operands of every instruction
+			options.checked = true;
+		else if (arg == "--trace")										// print every instruction executed
+			options.trace = true;
+		else if (arg == "--op-stats")									// report the number of instructions executed by type
+			options.opStats = true;
+		else if (arg == "--fuel" && i + 1 < argc)						// limit the number of backward jumps
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)			// limit the memory of the string values
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)					// limit the execution time (in milliseconds)
+			options.timeLimit = atoll(argv[++i]);
+		else if (arg == "--pipelined")									// scan the program on a thread of its own
+			pipelined = true;
+		else if (arg == "--lex-threads" && i + 1 < argc)				// scan parts of the program on several threads at once
+			lexingThreads = atoi(argv[++i]);
+		else if (arg == "--checkpoint" && i + 1 < argc)					// save the state of the run to the file now and then
+			options.checkpointFile = argv[++i];
+		else if (arg == "--checkpoint-interval" && i + 1 < argc)		// time between the checkpoints (in milliseconds)
+			options.checkpointInterval = atoll(argv[++i]);
+		else if (arg == "--resume")										// go on from the checkpoint file if there is one
+			options.resume = true;
+		else if (arg == "--result-cache" && i + 1 < argc)				// replay the results of runs made before
+			resultCache = argv[++i];
+		else
+			programName = arg;
+	}
+
+	if (mode == BLOCK_INPUT && programName.empty())						// stdin is read past cin, so it only carries the input
+	{
+		cerr << "--fast-input takes the code file name from the command line\n";
+		return 1;
+	}
+
+	system("cls");
+	if (programName.empty())
+	{
+		cout << "Enter code file name: ";
+		cin >> programName;
+	}
+
+	ifstream f(programName);
+	while (!f.good())
+	{
+		if (mode == BLOCK_INPUT)
+		{
+			cerr << "Cannot open file \'" << programName << "\'" << endl;
+			return 1;
+		}
+		cout << "Cannot open file \'" << programName << "\'. Please try again.\n" << endl;
+		cout << "Enter code file name: ";
+		cin >> programName;
+		f = ifstream(programName);
+	}
+
+	for (int i=0; i<amount*2; i++)
+	{
+		if (programName == tests[i])
+		{
+			isTest = 1;
+			testNum = i % amount + 1;
+		}
+	}
+
+	system("cls");
+	try
+	{
+		if (isTest)
+		{
+			system("cls");
+			cout << "==========================================TEST " << testNum << "=========================================\n\n";
+			cout << ".....................................Expexted result.....................................\n";
+		
+			getExpectedResults(testNum - 1);
+		
+			cout << "\n......................................Actual result......................................\n";
+		
+			Interpreter interpreter(ProgramSource::fromFile(programName), mode);
+			interpreter.setOptions(options);
+			interpreter.setPipelining(pipelined);
+			interpreter.setLexingThreads(lexingThreads);
+			if (!resultCache.empty())
+				interpreter.setResultCache(resultCache);
+			status = interpreter.interpret();
+			if (arenaStats)
+				cout << "Peak arena memory: " << interpreter.getPeakMemory() << " bytes\n";
+		
+			cout << "\n=========================================================================================\n\n";
+		}
+		else
+		{
+			Interpreter interpreter(ProgramSource::fromFile(programName), mode);
+			interpreter.setOptions(options);
+			interpreter.setPipelining(pipelined);
+			interpreter.setLexingThreads(lexingThreads);
+			if (!resultCache.empty())
+				interpreter.setResultCache(resultCache);
+			status = interpreter.interpret();
+			if (arenaStats)
+				cout << "Peak arena memory: " << interpreter.getPeakMemory() << " bytes\n";
+		}
+	}
+	catch (InterpreterError &error)										// the program is stopped by an error of its own
+	{
+		cerr << error.what() << endl;
+		return EXEC_ERROR;
+	}
+	cout << "Press any key to finish";
+	input = getch();
+	system("cls");
+	return status;
+}
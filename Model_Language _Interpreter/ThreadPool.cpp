@@ -0,0 +1,162 @@
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+
+//_________________________________________________WORK-STEALING POOL__________________________________________________
+// Every worker has a deque of tasks of its own: it takes its tasks from the back and, when it has none left, steals
+// from the front of the other workers' deques. Tasks are spread over the workers as they are submitted, so the
+// workers seldom meet on one deque; a worker that gets short tasks helps the others instead of standing idle.
+// The pool either runs a set of tasks to the end (run), or is started and fed with tasks while it works (start, submit,
+// finish); idle workers sleep until there is a task for them.
+class ThreadPool
+{
+	struct Worker
+	{
+		mutex lock;
+		deque<function<void()>> tasks;
+	};
+
+	vector<unique_ptr<Worker>> workers;
+	vector<thread> threads;
+	atomic<long> pending;												// tasks submitted, but not finished yet
+	atomic<long> queued;												// tasks submitted, but not taken by a worker yet
+	size_t nextWorker;													// worker to get the next submitted task
+	bool closed;														// indicator that no more tasks come from outside the pool
+	mutex idleLock;
+	condition_variable wake;											// idle workers wait for a task or the end of the work
+
+	static thread_local int currentWorker;								// number of the worker running on this thread (-1 - none)
+
+	// Take a task: from the back of the worker's own deque, or from the front of another one
+	bool take(int id, function<void()> &task)
+	{
+		{
+			lock_guard<mutex> guard(workers[id]->lock);
+			if (!workers[id]->tasks.empty())
+			{
+				task = move(workers[id]->tasks.back());
+				workers[id]->tasks.pop_back();
+				queued--;
+				return true;
+			}
+		}
+		for (size_t i = 1; i < workers.size(); i++)
+		{
+			Worker &victim = *workers[(id + i) % workers.size()];
+			lock_guard<mutex> guard(victim.lock);
+			if (!victim.tasks.empty())
+			{
+				task = move(victim.tasks.front());
+				victim.tasks.pop_front();
+				queued--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void work(int id)
+	{
+		currentWorker = id;
+		function<void()> task;
+		while (true)
+		{
+			if (take(id, task))
+			{
+				task();
+				task = nullptr;
+				if (--pending == 0)
+					notifyAll();										// the work may be over
+				continue;
+			}
+			unique_lock<mutex> guard(idleLock);							// the remaining tasks are being run by the others
+			if (closed && pending == 0)
+				break;
+			wake.wait(guard, [this] { return queued > 0 || (closed && pending == 0); });
+		}
+		currentWorker = -1;
+	}
+
+	void notifyAll()
+	{
+		lock_guard<mutex> guard(idleLock);
+		wake.notify_all();
+	}
+
+public:
+	// The pool is sized to the machine by default
+	ThreadPool(int count=0): pending(0), queued(0), nextWorker(0), closed(false)
+	{
+		if (count <= 0)
+			count = max(1u, thread::hardware_concurrency());
+		for (int i = 0; i < count; i++)
+			workers.push_back(make_unique<Worker>());
+	}
+
+	~ThreadPool()
+	{
+		finish();
+	}
+
+	// Add a task. A task submitted by a running task goes to the deque of its worker
+	void submit(function<void()> task)
+	{
+		int id = currentWorker >= 0 ? currentWorker : nextWorker++ % workers.size();
+		pending++;
+		queued++;
+		{
+			lock_guard<mutex> guard(workers[id]->lock);
+			workers[id]->tasks.push_back(move(task));
+		}
+		lock_guard<mutex> guard(idleLock);
+		wake.notify_one();
+	}
+
+	// Run the submitted tasks on all the workers until every one of them is finished
+	void run()
+	{
+		{
+			lock_guard<mutex> guard(idleLock);
+			closed = true;
+		}
+		for (size_t i = 1; i < workers.size(); i++)
+			threads.emplace_back(&ThreadPool::work, this, i);
+		work(0);														// the calling thread is a worker as well
+		finish();
+	}
+
+	// Start the workers on threads of their own: the tasks are run as they are submitted
+	void start()
+	{
+		for (size_t i = 0; i < workers.size(); i++)
+			threads.emplace_back(&ThreadPool::work, this, i);
+	}
+
+	// Wait until every submitted task is finished and stop the workers
+	void finish()
+	{
+		{
+			lock_guard<mutex> guard(idleLock);
+			closed = true;
+			wake.notify_all();
+		}
+		for (auto &t : threads)
+			t.join();
+		threads.clear();
+	}
+
+	int size()
+	{
+		return workers.size();
+	}
+};
+
+thread_local int ThreadPool::currentWorker = -1;
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <thread>
+#include <string>
+#include "LexicalAnalyser.cpp"
+
+using namespace std;
+
+
+//____________________________________________________LEXEME SOURCE____________________________________________________
+// Lexemes the parser takes from elsewhere than its own scanner (the scanner and the tables are left to the source)
+class LexemeSource
+{
+public:
+	virtual ~LexemeSource() {}
+
+	// Get the next lexeme (the end of the program is repeated once it has been reached, as the scanner does)
+	virtual Lexeme next() = 0;
+};
+
+
+//___________________________________________________SPSC RING BUFFER__________________________________________________
+// Bounded lock-free queue between one producer thread and one consumer thread. Each side owns one index and only
+// reads the other's; it keeps a copy of the other index and looks at the shared one only when the copy says the ring
+// is full (producer) or empty (consumer)
+template <class T, size_t CAPACITY>
+class SpscRing
+{
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the capacity must be a power of two");
+
+	T items[CAPACITY];
+	alignas(64) atomic<size_t> head;									// next item to be taken (written by the consumer)
+	size_t tailCopy;													// consumer's copy of the tail
+	alignas(64) atomic<size_t> tail;									// next free slot (written by the producer)
+	size_t headCopy;													// producer's copy of the head
+
+public:
+	SpscRing(): head(0), tailCopy(0), tail(0), headCopy(0) {}
+
+	// Move the item into the ring. Returns false (leaving the item as it is) if the ring is full
+	bool push(T &item)
+	{
+		size_t t = tail.load(memory_order_relaxed);
+		if (t - headCopy == CAPACITY)
+		{
+			headCopy = head.load(memory_order_acquire);
+			if (t - headCopy == CAPACITY)
+				return false;
+		}
+		items[t & (CAPACITY - 1)] = move(item);
+		tail.store(t + 1, memory_order_release);
+		return true;
+	}
+
+	// Move the oldest item out of the ring. Returns false if the ring is empty
+	bool pop(T &item)
+	{
+		size_t h = head.load(memory_order_relaxed);
+		if (h == tailCopy)
+		{
+			tailCopy = tail.load(memory_order_acquire);
+			if (h == tailCopy)
+				return false;
+		}
+		item = move(items[h & (CAPACITY - 1)]);
+		head.store(h + 1, memory_order_release);
+		return true;
+	}
+};
+
+
+//___________________________________________________TOKEN PIPELINE____________________________________________________
+// Lexeme passed from the scanner's thread to the parser
+struct pipelineToken
+{
+	Lexeme lex;
+	bool newSymbol;														// indicator that the lexeme's symbol has to be added to its table
+	bool failed;														// indicator of a lexical error (the scanner has stopped)
+	string text;														// the new symbol, or the message of the error
+};
+
+// Scanner running ahead of the parser on a thread of its own. The scanner numbers the identifiers and the string
+// constants by itself; the tables are only touched by the parser's thread, which adds each new symbol when it takes
+// the lexeme that has introduced it (so the tables end up exactly as a single-threaded scan leaves them).
+// A lexical error reaches the parser in its place among the lexemes.
+class TokenPipeline : public LexemeSource
+{
+	static const size_t RING_SIZE = 1 << 10;
+
+	Scanner &scanner;
+	SpscRing<pipelineToken, RING_SIZE> ring;
+	atomic<bool> cancelled;												// indicator that the parser has stopped taking lexemes
+	bool finished;														// indicator that the parser has taken the last lexeme
+	thread producer;
+
+	void produce()
+	{
+		pipelineToken token;
+		do
+		{
+			token = pipelineToken();
+			try
+			{
+				token.lex = scanner.getLexeme();
+				token.newSymbol = scanner.takeNewSymbol(token.text);
+			}
+			catch (InterpreterError &error)
+			{
+				token.failed = true;
+				token.text = error.what();
+			}
+			while (!ring.push(token))
+			{
+				if (cancelled)
+					return;
+				this_thread::yield();									// the parser is behind
+			}
+		}
+		while (!token.failed && token.lex.getType() != LEX_FIN);
+	}
+
+public:
+	TokenPipeline(Scanner &s): scanner(s), cancelled(false), finished(false)
+	{
+		scanner.deferTables();
+		producer = thread(&TokenPipeline::produce, this);
+	}
+
+	~TokenPipeline()
+	{
+		cancelled = true;
+		producer.join();
+	}
+
+	Lexeme next() override
+	{
+		if (finished)
+			return Lexeme(LEX_FIN);
+		pipelineToken token;
+		while (!ring.pop(token))
+			this_thread::yield();										// the scanner is behind
+		if (token.failed)
+		{
+			finished = true;
+			throw InterpreterError(token.text);
+		}
+		if (token.newSymbol)
+		{
+			if (token.lex.getType() == LEX_ID)
+				addUniqueIdent(token.text, scanner.getMemory());
+			else
+				addUniqueStrConst(token.text);
+		}
+		finished = token.lex.getType() == LEX_FIN;
+		return token.lex;
+	}
+};
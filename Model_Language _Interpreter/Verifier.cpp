@@ -0,0 +1,512 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include "RPN_Generator.cpp"
+
+using namespace std;
+
+
+//__________________________________________________RPN VERIFICATION___________________________________________________
+struct verification
+{
+	bool verified;														// indicator that the RPN is safe for the unchecked executer
+	int maxArgs;														// maximum depth of the int / bool arguments stack
+	int maxStrings;														// maximum depth of the string values stack
+	int maxTypes;														// maximum depth of the types stack
+	string error;														// the reason the RPN could not be verified
+};
+
+
+//____________________________________________________RPN VERIFIER_____________________________________________________
+// Abstract interpretation of the RPN: the executer's stacks are followed along every control flow path without the
+// values themselves (only what kind of item is kept in the arguments stack). The stacks must have the same contents
+// whenever a jump target is reached, and no instruction may take more than there is. The body of every function of
+// the program is followed from its entry with empty stacks of its own (a call only takes its arguments and gives its
+// result), and must leave them empty when it returns.
+class Verifier
+{
+	enum argKind
+	{
+		ARG_VALUE,														// int / bool value
+		ARG_ADDRESS,													// identifier's address
+		ARG_LOCAL_ADDRESS,												// address of a local variable (its slot)
+		ARG_LABEL														// jump target
+	};
+
+	struct argItem
+	{
+		argKind kind;
+		int value;														// identifier's address, slot or jump target
+
+		bool operator == (const argItem &other) const
+		{
+			return kind == other.kind && (kind == ARG_VALUE || value == other.value);
+		}
+	};
+
+public:
+	// Contents of the executer's stacks
+	struct state
+	{
+		vector<argItem> args;
+		int strings;
+		vector<lexemeType> types;
+		int function = -1;												// function the path is in (-1 : none)
+
+		bool operator == (const state &other) const
+		{
+			return strings == other.strings && function == other.function && args == other.args && types == other.types;
+		}
+	};
+
+private:
+	const pmr::vector<Lexeme> &RPNs;
+	const NativeFunctions *natives;										// functions the RPN may call (none - nullptr)
+	const vector<programFunction> *functions;							// functions of the program (none - nullptr)
+	int size;
+	verification result;
+	vector<int> assigned;												// identifier assigned by each instruction (or -1)
+	vector<int> jumps;													// target of each jump instruction (or -1)
+
+	// Verification failure
+	bool fail(int index, string err)
+	{
+		result.verified = false;
+		result.error = "instruction " + to_string(index) + ": " + err;
+		return false;
+	}
+
+	bool popArg(state &s, argItem &item)
+	{
+		if (s.args.empty())
+			return false;
+		item = s.args.back();
+		s.args.pop_back();
+		return true;
+	}
+
+	bool popType(state &s, lexemeType &type)
+	{
+		if (s.types.empty())
+			return false;
+		type = s.types.back();
+		s.types.pop_back();
+		return true;
+	}
+
+	// Take a value of the given type (from the strings stack or the arguments stack)
+	bool popValue(state &s, lexemeType type)
+	{
+		argItem item;
+		if (type == LEX_STRING)
+			return s.strings-- > 0;
+		return popArg(s, item);
+	}
+
+	// Take the arguments of a call, checking that each one is kept where its parameter is
+	bool popArguments(state &s, int index, const lexemeType params[], int count)
+	{
+		lexemeType type;
+		for (int i = count - 1; i >= 0; i--)
+		{
+			if (!popType(s, type))
+				return false;
+			if ((type == LEX_STRING) != (params[i] == LEX_STRING))
+				return fail(index, "argument of a wrong type");
+			if (!popValue(s, type))
+				return false;
+		}
+		return true;
+	}
+
+	// Give a value of the given type (to the strings stack or the arguments stack)
+	void pushValue(state &s, lexemeType type)
+	{
+		if (type == LEX_STRING)
+			s.strings++;
+		else
+			s.args.push_back(argItem {ARG_VALUE, 0});
+		s.types.push_back(type);
+	}
+
+	// Type of the local variable in the slot of the path's function (LEX_NULL if there is no such variable)
+	lexemeType localType(const state &s, int slot)
+	{
+		if (s.function < 0 || slot < 0 || slot >= (int) (*functions)[s.function].locals.size())
+			return LEX_NULL;
+		return (*functions)[s.function].locals[slot];
+	}
+
+	// Apply one instruction to the abstract state. Returns false if the instruction cannot be executed
+	bool step(state &s, int index, int &jump);
+
+	// Follow every path from the beginning of the RPN with the given stacks. With exit given, the paths coming to the
+	// end must agree, and their stacks are kept there
+	verification follow(state entry, state *exit);
+
+public:
+	Verifier(const pmr::vector<Lexeme> &rpn, const NativeFunctions *nativeFunctions=nullptr,
+			 const vector<programFunction> *programFunctions=nullptr):
+		RPNs(rpn), natives(nativeFunctions), functions(programFunctions), size(rpn.size()), assigned(size, -1),
+		jumps(size, -1)
+	{}
+
+	verification verify();
+
+	// Verify the RPN of a part of a program (e.g. one of its statements), entered with the given stacks: every path
+	// through it must leave it at its end, with the same stacks, which are given back
+	verification verify(state &stacks);
+
+	// Identifier assigned by the instruction (-1 if it assigns nothing). Valid for a verified RPN
+	int getAssigned(int index) const
+	{
+		return assigned[index];
+	}
+
+	// Target of the jump instruction. Valid for a verified RPN
+	int getJump(int index) const
+	{
+		return jumps[index];
+	}
+};
+
+
+verification Verifier::verify()
+{
+	return follow(state {{}, 0, {}}, nullptr);
+}
+
+verification Verifier::verify(state &stacks)
+{
+	return follow(stacks, &stacks);
+}
+
+verification Verifier::follow(state entry, state *exit)
+{
+	result = verification {true, 0, 0, 0, ""};
+	bool ended = false;													// indicator that a path has come to the end
+
+	vector<bool> isTarget(size + 1, false);								// every label is a possible jump target
+	for (int i = 0; i < size; i++)
+		if (RPNs[i].getType() == RPN_LABEL)
+		{
+			int target = RPNs[i].getValue();
+			if (target < 0 || target > size)
+			{
+				fail(i, "jump target out of the program");
+				return result;
+			}
+			isTarget[target] = true;
+		}
+
+	vector<unique_ptr<state>> targetStates(size + 1);					// stacks' contents at the jump targets
+	vector<pair<int, state>> paths;										// control flow paths yet to be followed
+	result.maxArgs = entry.args.size();
+	result.maxStrings = entry.strings;
+	result.maxTypes = entry.types.size();
+	paths.push_back({0, move(entry)});
+	for (int f = 0; !exit && functions && f < (int) functions->size(); f++)	// every function from its entry
+	{
+		int start = (*functions)[f].entry;
+		if (start < 0 || start >= size)
+		{
+			fail(start, "function entry out of the program");
+			return result;
+		}
+		paths.push_back({start, state {{}, 0, {}, f}});
+	}
+
+	while (!paths.empty())
+	{
+		int index = paths.back().first;
+		state s = move(paths.back().second);
+		paths.pop_back();
+
+		while (index < size)
+		{
+			if (isTarget[index])
+			{
+				if (targetStates[index])								// the target has been reached before:
+				{
+					if (!(*targetStates[index] == s))					//   the stacks must be the same
+						fail(index, "stacks differ between the paths leading here");
+					break;
+				}
+				targetStates[index].reset(new state(s));
+			}
+
+			int jump = -1;
+			lexemeType instruction = RPNs[index].getType();
+			if (!step(s, index, jump))
+			{
+				if (result.verified)
+					fail(index, "not enough operands");
+				return result;
+			}
+			result.maxArgs = max(result.maxArgs, (int) s.args.size());
+			result.maxStrings = max(result.maxStrings, s.strings);
+			result.maxTypes = max(result.maxTypes, (int) s.types.size());
+
+			if (instruction == RPN_RETURN)								// the path goes back to the calls of its function
+				break;
+			if (instruction == RPN_GO)									// unconditional jump: the path goes on from the target
+				index = jump;
+			else
+			{
+				if (instruction == RPN_FGO)								// conditional jump: both paths are followed
+					paths.push_back({jump, s});
+				index++;
+			}
+		}
+		if (!result.verified)
+			return result;
+		if (s.function >= 0 && index >= size)
+		{
+			fail(size, "the body of a function runs past the end of the program");
+			return result;
+		}
+		if (exit && index >= size)										// the path has come to the end of the part
+		{
+			if (ended && !(*exit == s))
+				fail(size, "stacks differ between the paths leaving the part");
+			if (!result.verified)
+				return result;
+			*exit = move(s);
+			ended = true;
+		}
+	}
+	if (exit && !ended)
+		fail(size, "no path leaves the part");
+	return result;
+}
+
+bool Verifier::step(state &s, int index, int &jump)
+{
+	Lexeme lex = RPNs[index];
+	int value = lex.getValue();
+	lexemeType type;
+	argItem item;
+
+	switch (lex.getType())
+	{
+		case RPN_LABEL:
+			s.args.push_back(argItem {ARG_LABEL, value});
+			return true;
+
+		case RPN_ADDRESS:
+			if (value < 0 || value >= (int) identTable.size())
+				return fail(index, "unknown identifier");
+			s.args.push_back(argItem {ARG_ADDRESS, value});
+			s.types.push_back(identTable[value].getType());
+			return true;
+
+		case LEX_NUM:
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			s.types.push_back(LEX_INT);
+			return true;
+
+		case LEX_TRUE: case LEX_FALSE:
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			s.types.push_back(LEX_BOOL);
+			return true;
+
+		case LEX_STR_CONST:
+			if (value < 0 || value >= (int) strConstTable.size())
+				return fail(index, "unknown string constant");
+			s.strings++;
+			s.types.push_back(LEX_STRING);
+			return true;
+
+		case LEX_ID: case RPN_LOAD:
+			if (value < 0 || value >= (int) identTable.size())
+				return fail(index, "unknown identifier");
+			type = identTable[value].getType();
+			if (type == LEX_STRING)
+				s.strings++;
+			else
+				s.args.push_back(argItem {ARG_VALUE, 0});
+			s.types.push_back(type);
+			return true;
+
+		case RPN_LOCAL_ADDRESS:
+			type = localType(s, value);
+			if (type == LEX_NULL)
+				return fail(index, "unknown local variable");
+			s.args.push_back(argItem {ARG_LOCAL_ADDRESS, value});
+			s.types.push_back(type);
+			return true;
+
+		case RPN_LOCAL:
+			type = localType(s, value);
+			if (type == LEX_NULL)
+				return fail(index, "unknown local variable");
+			pushValue(s, type);
+			return true;
+
+		case LEX_NOT: case LEX_UNARY_MINUS:
+			if (!popArg(s, item))
+				return false;
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			return true;
+
+		case LEX_OR: case LEX_AND: case LEX_MINUS: case LEX_TIMES: case LEX_SLASH: case LEX_PERCENT:
+			if (!popArg(s, item) || !popArg(s, item) || !popType(s, type))
+				return false;
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			return true;
+
+		case LEX_PLUS:
+			if (!popType(s, type))
+				return false;
+			if (type == LEX_STRING)
+			{
+				if (s.strings < 2)
+					return false;
+				s.strings--;
+			}
+			else
+			{
+				if (!popArg(s, item) || !popArg(s, item))
+					return false;
+				s.args.push_back(argItem {ARG_VALUE, 0});
+			}
+			return true;
+
+		case LEX_PP_PRE: case LEX_MM_PRE:
+			if (!popArg(s, item))
+				return false;
+			if (item.kind != ARG_ADDRESS && item.kind != ARG_LOCAL_ADDRESS)
+				return fail(index, "increment of a value that is not an identifier");
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			return true;
+
+		case LEX_EQ: case LEX_NOT_EQ: case LEX_LESS: case LEX_GREATER: case LEX_LESS_EQ: case LEX_GREATER_EQ:
+			if (s.types.empty())
+				return false;
+			if (s.types.back() == LEX_STRING && (lex.getType() != LEX_LESS_EQ && lex.getType() != LEX_GREATER_EQ))
+			{
+				if (s.strings < 2)
+					return false;
+				s.strings -= 2;
+			}
+			else if (!popArg(s, item) || !popArg(s, item))
+				return false;
+			if (!popType(s, type) || !popType(s, type))
+				return false;
+			s.args.push_back(argItem {ARG_VALUE, 0});
+			s.types.push_back(LEX_BOOL);
+			return true;
+
+		case LEX_ASSIGN:
+			if (!popType(s, type) || s.types.empty())
+				return false;
+			switch (s.types.back())
+			{
+				case LEX_STRING:
+					if (s.strings-- == 0)
+						return false;
+					break;
+
+				case LEX_BOOL: case LEX_INT:
+					if (!popArg(s, item))
+						return false;
+					break;
+
+				default:
+					return fail(index, "assignment to an identifier without a type");
+			}
+			if (!popArg(s, item))
+				return false;
+			if (item.kind != ARG_ADDRESS && item.kind != ARG_LOCAL_ADDRESS)
+				return fail(index, "assignment to a value that is not an identifier");
+			if (item.kind == ARG_ADDRESS)								// local variables are always checked
+				assigned[index] = item.value;
+			s.types.pop_back();
+			return true;
+
+		case RPN_GO:
+			if (!popArg(s, item))
+				return false;
+			if (item.kind != ARG_LABEL)
+				return fail(index, "jump to a value that is not a label");
+			jump = item.value;
+			jumps[index] = jump;
+			return true;
+
+		case RPN_FGO:
+			if (!popArg(s, item))
+				return false;
+			if (item.kind != ARG_LABEL)
+				return fail(index, "jump to a value that is not a label");
+			jump = item.value;
+			jumps[index] = jump;
+			if (!popArg(s, item) || !popType(s, type))
+				return false;
+			return true;
+
+		case LEX_WRITE: case LEX_WRITELINE:								// write() takes every value there is
+			while (!s.types.empty())
+			{
+				type = s.types.back();
+				s.types.pop_back();
+				if ((type == LEX_STRING || type == LEX_INT || type == LEX_BOOL) && !popValue(s, type))
+					return false;
+			}
+			return true;
+
+		case RPN_CALL_NATIVE:											// the arguments are taken in the order of the parameters
+		{
+			if (!natives || value < 0 || value >= natives->size())
+				return fail(index, "unknown native function");
+			const nativeFunction &function = natives->get(value);
+			if (!popArguments(s, index, function.params.data(), function.params.size()))
+				return false;
+			pushValue(s, function.result);
+			return true;
+		}
+
+		case RPN_CALL:													// the entry label is over the arguments
+		{
+			if (!functions || value < 0 || value >= (int) functions->size())
+				return fail(index, "unknown function");
+			const programFunction &function = (*functions)[value];
+			if (!popArg(s, item))
+				return false;
+			if (item.kind != ARG_LABEL || item.value != function.entry)
+				return fail(index, "call of a function at a wrong entry");
+			if (!popArguments(s, index, function.locals.data(), function.params))
+				return false;
+			pushValue(s, function.result);
+			return true;
+		}
+
+		case RPN_RETURN:												// the result (if it is given) is all there is left
+			if (s.function < 0)
+				return fail(index, "return outside of a function");
+			if (value)
+			{
+				if (!popType(s, type))
+					return false;
+				if ((type == LEX_STRING) != ((*functions)[s.function].result == LEX_STRING))
+					return fail(index, "result of a wrong type");
+				if (!popValue(s, type))
+					return false;
+			}
+			if (!s.args.empty() || s.strings || !s.types.empty())
+				return fail(index, "values are left on the stacks at the return");
+			return true;
+
+		case LEX_READ:
+			if (!popArg(s, item) || s.types.empty())
+				return false;
+			if (item.kind != ARG_ADDRESS && item.kind != ARG_LOCAL_ADDRESS)
+				return fail(index, "reading into a value that is not an identifier");
+			if (item.kind == ARG_ADDRESS)
+				assigned[index] = item.value;
+			s.types.pop_back();
+			return true;
+
+		default:
+			return fail(index, "unknown element");
+	}
+}
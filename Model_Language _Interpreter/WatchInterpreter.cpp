@@ -0,0 +1,152 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "IncrementalCompiler.cpp"
+
+using namespace std;
+
+
+//_______________________________________________________WATCHING______________________________________________________
+// Read the whole file. Returns false if it cannot be opened
+bool readFile(const string &fileName, string &text)
+{
+	ifstream file(fileName);
+	if (!file)
+		return false;
+	text.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	return true;
+}
+
+// Wait until the file is written (or replaced, as editors often save files) in its directory
+bool waitForSave(int watcher, const string &name)
+{
+	alignas(inotify_event) char events[sizeof(inotify_event) + NAME_MAX + 1];
+	while (true)
+	{
+		ssize_t length = read(watcher, events, sizeof(events));
+		if (length < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		for (char *p = events; p < events + length; p += sizeof(inotify_event) + ((inotify_event*) p)->len)
+		{
+			inotify_event *event = (inotify_event*) p;
+			if (event->len && name == event->name)
+				return true;
+		}
+	}
+}
+
+double milliseconds(chrono::steady_clock::duration d)
+{
+	return chrono::duration<double, milli>(d).count();
+}
+
+// Compile the program's new text and run it, reporting the time from the save to the end of the run
+void compileAndRun(IncrementalCompiler &compiler, ExecutionContext &context, const string &text, const string &input,
+				   chrono::steady_clock::time_point saved)
+{
+	cout << "----------------------------------------------------------------------------------------------------\n";
+	try
+	{
+		compiler.update(text);
+		auto compiled = chrono::steady_clock::now();
+		istringstream in(input);
+		programStreams streams;
+		streams.in = &in;
+		executionStatus status = context.run(compiler.getProgram(), streams);
+		auto finished = chrono::steady_clock::now();
+		cout << flush;
+		cerr << fixed << setprecision(3) << "[status " << status << "; ";
+		if (compiler.compiledWhole())
+			cerr << "compiled whole";
+		else
+			cerr << "analysed " << compiler.getAnalysed() << " of " << compiler.getStatements() << " statements";
+		cerr << " in " << milliseconds(compiled - saved) << " ms, result " << milliseconds(finished - saved)
+			 << " ms after the save]" << endl;
+	}
+	catch (InterpreterError &error)
+	{
+		cout << flush;
+		cerr << error.what() << endl;
+	}
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: WatchInterpreter [--input FILE] [--fuel N] [--max-string-bytes N] [--time-limit MS] program
+// Runs the program, and runs it again every time its file is saved, analysing again only the statements that have
+// changed (see IncrementalCompiler.cpp). Its read() takes the values from the input file, read anew for every run
+int main(int argc, char *argv[])
+{
+	string fileName;
+	string inputName;
+	executionOptions options = executionOptions();
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--input" && i + 1 < argc)							// values for the program's read()
+			inputName = argv[++i];
+		else if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+			fileName = arg;
+	}
+	if (fileName.empty())
+	{
+		cerr << "Usage: " << argv[0] << " [--input FILE] [--fuel N] [--max-string-bytes N] [--time-limit MS] program\n";
+		return 1;
+	}
+	options.quiet = true;												// the runs are told apart by the report after them
+
+	size_t slash = fileName.rfind('/');
+	string directory = slash == string::npos ? "." : fileName.substr(0, slash + 1);
+	string name = slash == string::npos ? fileName : fileName.substr(slash + 1);
+	int watcher = inotify_init1(IN_CLOEXEC);
+	if (watcher < 0 || inotify_add_watch(watcher, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		cerr << "Cannot watch " << directory << ": " << strerror(errno) << endl;
+		return 1;
+	}
+
+	IncrementalCompiler compiler(cerr);
+	ExecutionContext context(options);
+	string text;
+	string input;
+	if (!readFile(fileName, text))
+	{
+		cerr << "Cannot open the program file " << fileName << endl;
+		return 1;
+	}
+	if (!inputName.empty())
+		readFile(inputName, input);
+	compileAndRun(compiler, context, text, input, chrono::steady_clock::now());
+
+	while (waitForSave(watcher, name))
+	{
+		auto saved = chrono::steady_clock::now();
+		string newText;
+		if (!readFile(fileName, newText) || newText == text)			// a save that has not changed anything
+			continue;
+		text = move(newText);
+		if (!inputName.empty())
+			readFile(inputName, input);
+		compileAndRun(compiler, context, text, input, saved);
+	}
+	cerr << "Cannot watch " << directory << ": " << strerror(errno) << endl;
+	return 1;
+}
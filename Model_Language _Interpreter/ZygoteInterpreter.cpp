@@ -0,0 +1,188 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <csignal>
+#include <sys/types.h>
+#include "Interpreter.cpp"
+#include "ServerProtocol.cpp"
+
+using namespace std;
+
+
+//___________________________________________________PRELOADED PROGRAMS________________________________________________
+// Programs compiled by the parent before it serves any request. A child gets them with the rest of the parent's memory
+// (copy-on-write), so it does not analyse them again
+struct preloadedProgram
+{
+	string source;
+	shared_ptr<const CompiledProgram> program;
+	string warnings;													// warnings of the analysis, sent with every run
+};
+
+// Compile the program text. Throws InterpreterError if it cannot be compiled
+preloadedProgram compileSource(const string &source)
+{
+	ostringstream messages;												// the parser's report of a successful analysis
+	ostringstream warnings;
+	programStreams streams;
+	streams.out = &messages;
+	streams.err = &warnings;
+	Interpreter interpreter(source, STREAM_INPUT, nullptr, streams);
+	interpreter.compile();
+	return preloadedProgram {source, interpreter.share(), warnings.str()};
+}
+
+
+//_________________________________________________________CHILD_______________________________________________________
+// Serve the request of the connection in a child process: read the program and its input, run it and send back its
+// output and status. The program is taken from the preloaded ones if it is among them (by path or by text), and
+// analysed by the child otherwise. Returns the status of the run
+executionStatus serveChild(int fd, const map<string, preloadedProgram> &programs, const executionOptions &options)
+{
+	FrameReader reader(fd);
+	programRequest request;
+	if (!readRequest(reader, request))
+		return EXEC_ERROR;
+
+	FrameStreamBuf outBuf(fd, "OUT");
+	FrameStreamBuf errBuf(fd, "ERR");
+	ostream out(&outBuf);
+	ostream err(&errBuf);
+	istringstream in(request.input);
+	programStreams streams;
+	streams.in = &in;
+	streams.out = &out;
+	streams.err = &err;
+
+	executionStatus status;
+	try
+	{
+		const preloadedProgram *found = nullptr;
+		if (request.byPath)
+		{
+			auto it = programs.find(request.program);
+			if (it != programs.end())
+				found = &it->second;
+		}
+		else
+			for (auto &entry : programs)
+				if (entry.second.source == request.program)
+					found = &entry.second;
+
+		preloadedProgram compiled;
+		if (!found)														// not preloaded: analysed in the child
+		{
+			string source = request.program;
+			if (request.byPath)
+			{
+				ifstream file(request.program);
+				if (!file)
+					throw InterpreterError("Cannot open the program file " + request.program);
+				source.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+			}
+			compiled = compileSource(source);
+			found = &compiled;
+		}
+		err << found->warnings;
+		ExecutionContext context(options);
+		status = context.run(*found->program, streams);
+	}
+	catch (InterpreterError &error)
+	{
+		err << error.what() << endl;
+		status = EXEC_ERROR;
+	}
+	out.flush();
+	err.flush();
+	sendFrame(fd, "STATUS", to_string(status));
+	return status;
+}
+
+
+//________________________________________________________MAIN_________________________________________________________
+// Command line: ZygoteInterpreter [--socket PATH] [--fuel N] [--max-string-bytes N] [--time-limit MS] programs...
+// Compiles the programs, and then serves requests to run programs (see ServerProtocol.cpp) until it is stopped, each
+// one in a child process forked for it
+int main(int argc, char *argv[])
+{
+	string socketPath = "/tmp/model_interpreter.sock";
+	executionOptions options = executionOptions();
+	vector<string> fileNames;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--socket" && i + 1 < argc)							// path of the Unix domain socket
+			socketPath = argv[++i];
+		else if (arg == "--fuel" && i + 1 < argc)
+			options.fuel = atoll(argv[++i]);
+		else if (arg == "--max-string-bytes" && i + 1 < argc)
+			options.stringBytes = atoll(argv[++i]);
+		else if (arg == "--time-limit" && i + 1 < argc)
+			options.timeLimit = atoll(argv[++i]);
+		else
+			fileNames.push_back(arg);
+	}
+	options.quiet = true;												// the output of a run is only the program's
+
+	map<string, preloadedProgram> programs;								// preloaded programs by their paths
+	for (auto &fileName : fileNames)
+	{
+		ifstream file(fileName);
+		if (!file)
+		{
+			cerr << "Cannot open the program file " << fileName << endl;
+			return 1;
+		}
+		string source(istreambuf_iterator<char>(file), (istreambuf_iterator<char>()));
+		try
+		{
+			programs[fileName] = compileSource(source);
+		}
+		catch (InterpreterError &error)
+		{
+			cerr << fileName << ": " << error.what() << endl;
+			return 1;
+		}
+	}
+
+	int listener = listenOn(socketPath);
+	if (listener < 0)
+	{
+		cerr << "Cannot listen on " << socketPath << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	signal(SIGPIPE, SIG_IGN);											// a client that has gone is noticed by send()
+	signal(SIGCHLD, SIG_IGN);											// the children are not waited for
+
+	cerr << "Listening on " << socketPath << " with " << programs.size() << " preloaded programs" << endl;
+	while (true)
+	{
+		int fd = accept(listener, nullptr, nullptr);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			cerr << "accept: " << strerror(errno) << endl;
+			break;
+		}
+		pid_t child = fork();
+		if (child == 0)
+		{
+			close(listener);
+			executionStatus status = serveChild(fd, programs, options);
+			close(fd);
+			_exit(status);												// nothing of the parent's is torn down in the child
+		}
+		if (child < 0)
+		{
+			sendFrame(fd, "ERR", string("Cannot start a process: ") + strerror(errno) + "\n");
+			sendFrame(fd, "STATUS", to_string(EXEC_ERROR));
+		}
+		close(fd);
+	}
+	close(listener);
+	return 1;
+}